@@ -11,6 +11,7 @@
 #include <filesystem>
 #include <optional>
 #include <locale>
+#include <charconv>
 namespace peo::detail { class byte_view; }
 namespace peo::type_traits {
 template <typename T> constexpr auto underlying_char_f() {
@@ -30,37 +31,101 @@ template <typename Char = char> [[nodiscard]] auto read_file_to_string(const std
 template <typename T>           [[nodiscard]] auto read_file_to_vector(const std::filesystem::path& filepath) -> std::vector<T>;
 template <typename Str>                       auto write_string_to_file(const Str& str, const std::filesystem::path& filepath) -> void;
 inline                                        auto write_vector_to_file(const detail::byte_view& bytevector, const std::filesystem::path& filepath) -> void;
+template <typename Str0, typename Str1>       auto replace_all_in_file(const std::filesystem::path& src_filepath, const std::filesystem::path& dst_filepath, const Str0& needle, const Str1& replacement) -> size_t; // Streams the file, returns number of replacements
+template <typename Str0, typename Str1>       auto replace_all_in_file_inplace(const std::filesystem::path& filepath, const Str0& needle, const Str1& replacement) -> size_t; // Requires equal sizes, returns number of replacements
 
 // Convert any type to string
-template <typename T> [[nodiscard]] auto pretty_string(const T& val) -> std::string;
+template <typename T>                     [[nodiscard]] auto pretty_string(const T& val) -> std::string;
+template <typename T>                                   auto pretty_string_to(std::string& out, const T& val) -> void; // Appends to out
+// Strings are rejected as OutputIt, a string destination has to be a non-const std::string lvalue
+template <
+	typename OutputIt, 
+	typename T, 
+	std::enable_if_t<!std::is_convertible_v<OutputIt, std::string_view> || std::is_same_v<OutputIt, char*>, int> = 0
+> auto pretty_string_to(OutputIt out, const T& val) -> OutputIt; // Returns the end of the written chars
+
+// Character sets, constexpr constructible, ie char_set{ " \t\r\n" }.
+// Accepted in place of a string of chars by the split and trim functions.
+template <typename Char> class basic_char_set;
+using char_set = basic_char_set<char>;
 
 // String - split
 template <typename Str0, typename Str1> [[nodiscard]] auto split_string(const Str0& str, const Str1& delimiters) -> std::vector<std::basic_string<type_traits::underlying_char_t<Str0>>>;
+template <typename Str0, typename Char> [[nodiscard]] auto split_string(const Str0& str, const basic_char_set<Char>& delimiters) -> std::vector<std::basic_string<Char>>;
 template <typename Str0, typename Str1> [[nodiscard]] auto split_string_to_views(const Str0& str, const Str1& delimiters) -> std::vector<std::basic_string_view<type_traits::underlying_char_t<Str0>>>;
+template <typename Str0, typename Char> [[nodiscard]] auto split_string_to_views(const Str0& str, const basic_char_set<Char>& delimiters) -> std::vector<std::basic_string_view<Char>>;
 template <typename Char, typename Str0> [[nodiscard]] auto split_string_to_views(std::basic_string<Char>&& str, Str0&& delimiters) -> std::vector<std::basic_string_view<Char>> = delete; // Prevent dangling std::string_view
+template <typename Char>                [[nodiscard]] auto split_string_to_views(std::basic_string<Char>&& str, const basic_char_set<Char>& delimiters) -> std::vector<std::basic_string_view<Char>> = delete; // Prevent dangling std::string_view
 template <typename Str>                 [[nodiscard]] auto split_string_to_lines(const Str& str) -> std::vector<std::basic_string<type_traits::underlying_char_t<Str>>>;
 
+// Case folding tables of a locale, accepted in place of std::locale by the 
+// case insensitive functions. Faster than looking up the facets per char.
+class case_folder;
+
 // String - replace
 template <typename Char, typename Str0, typename Str1> [[nodiscard]] auto replace_all(std::basic_string<Char> haystack, const Str0& needle, const Str1& replacement) -> std::basic_string<Char>; // Noexcept if dst.size() <= src.size() 
 template <typename Str0, typename Str1, typename Str2> [[nodiscard]] auto replace_all(const Str0& haystack, const Str1& needle, const Str2& replacement) -> std::basic_string<type_traits::underlying_char_t<Str0>>;
 template <typename Char, typename Str0, typename Str1> [[nodiscard]] auto replace_all_ignore_case(std::basic_string<Char> haystack, const Str0& needle, const Str1& replacement, const std::locale& loc = std::locale{})->std::basic_string<Char>; // Noexcept if dst.size() <= src.size() 
 template <typename Str0, typename Str1, typename Str2> [[nodiscard]] auto replace_all_ignore_case(const Str0& haystack, const Str1& needle, const Str2& replacement, const std::locale& loc = std::locale{}) -> std::basic_string<type_traits::underlying_char_t<Str0>>;
+template <typename Char, typename Str0, typename Str1> [[nodiscard]] auto replace_all_ignore_case(std::basic_string<Char> haystack, const Str0& needle, const Str1& replacement, const case_folder& folder) -> std::basic_string<Char>;
+template <typename Str0, typename Str1, typename Str2> [[nodiscard]] auto replace_all_ignore_case(const Str0& haystack, const Str1& needle, const Str2& replacement, const case_folder& folder) -> std::basic_string<type_traits::underlying_char_t<Str0>>;
+template <typename Str0, typename Str1, typename Str2> [[nodiscard]] auto replace_all_parallel(const Str0& haystack, const Str1& needle, const Str2& replacement, size_t num_threads = 0) -> std::basic_string<type_traits::underlying_char_t<Str0>>; // num_threads = 0 utilizes all hardware threads
+
+// String - precompiled searchers, reusable for many haystacks
+template <typename Char> class searcher;
+template <typename Char> class searcher_ignore_case;
+template <typename Char, typename Str0>                [[nodiscard]] auto replace_all(std::basic_string<Char> haystack, const searcher<Char>& needle, const Str0& replacement) -> std::basic_string<Char>;
+template <typename Str0, typename Char, typename Str1> [[nodiscard]] auto replace_all(const Str0& haystack, const searcher<Char>& needle, const Str1& replacement) -> std::basic_string<Char>;
+template <typename Char, typename Str0>                [[nodiscard]] auto replace_all(std::basic_string<Char> haystack, const searcher_ignore_case<Char>& needle, const Str0& replacement) -> std::basic_string<Char>;
+template <typename Str0, typename Char, typename Str1> [[nodiscard]] auto replace_all(const Str0& haystack, const searcher_ignore_case<Char>& needle, const Str1& replacement) -> std::basic_string<Char>;
+
+// String - multi-needle searchers, reusable for many haystacks
+template <bool IgnoreCase> class basic_multi_searcher;
+using multi_searcher = basic_multi_searcher<false>;
+using multi_searcher_ignore_case = basic_multi_searcher<true>; // Folds ASCII letters
 
 // String - trim
 template <typename Str0>                [[nodiscard]] auto is_trimmed(const Str0& str, const std::locale& loc = std::locale{}) noexcept -> bool;
+template <typename Str0>                [[nodiscard]] auto is_trimmed(const Str0& str, const case_folder& folder) noexcept -> bool;
 template <typename Str0, typename Str1> [[nodiscard]] auto is_trimmed(const Str0& str, const Str1& trim_chars) noexcept -> bool;
+template <typename Str0, typename Char> [[nodiscard]] auto is_trimmed(const Str0& str, const basic_char_set<Char>& trim_chars) noexcept -> bool;
 template <typename Char>                [[nodiscard]] auto trim_string(std::basic_string<Char> str, const std::locale& loc = std::locale{}) noexcept -> std::basic_string<Char>;
+template <typename Char>                [[nodiscard]] auto trim_string(std::basic_string<Char> str, const case_folder& folder) noexcept -> std::basic_string<Char>;
 template <typename Char, typename Str0> [[nodiscard]] auto trim_string(std::basic_string<Char> str, const Str0& trim_chars) noexcept -> std::basic_string<Char>;
+template <typename Char>                [[nodiscard]] auto trim_string(std::basic_string<Char> str, const basic_char_set<Char>& trim_chars) noexcept -> std::basic_string<Char>;
 template <typename Str0>                [[nodiscard]] auto trim_string_to_view(const Str0& str, const std::locale& loc = std::locale{}) noexcept -> std::basic_string_view<type_traits::underlying_char_t<Str0>>;
+template <typename Str0>                [[nodiscard]] auto trim_string_to_view(const Str0& str, const case_folder& folder) noexcept -> std::basic_string_view<type_traits::underlying_char_t<Str0>>;
 template <typename Str0, typename Str1> [[nodiscard]] auto trim_string_to_view(const Str0& str, const Str1& trim_chars) noexcept -> std::basic_string_view<type_traits::underlying_char_t<Str0>>;
+template <typename Str0, typename Char> [[nodiscard]] auto trim_string_to_view(const Str0& str, const basic_char_set<Char>& trim_chars) noexcept -> std::basic_string_view<Char>;
 template <typename Char>                [[nodiscard]] auto trim_string_to_view(std::basic_string<Char>&& str, const std::locale& loc = std::locale{}) noexcept -> std::basic_string_view<Char> = delete; // Prevent dangling std::string_view
 template <typename Char, typename Str0> [[nodiscard]] auto trim_string_to_view(std::basic_string<Char>&& str, const Str0& trim_chars) noexcept -> std::basic_string_view<Char> = delete; // Prevent dangling std::string_view
+template <typename Char>                [[nodiscard]] auto trim_string_to_view(std::basic_string<Char>&& str, const case_folder& folder) noexcept -> std::basic_string_view<Char> = delete; // Prevent dangling std::string_view
+template <typename Char>                [[nodiscard]] auto trim_string_to_view(std::basic_string<Char>&& str, const basic_char_set<Char>& trim_chars) noexcept -> std::basic_string_view<Char> = delete; // Prevent dangling std::string_view
+
+// String - trim every string of a contiguous container, ie a std::vector, std::basic_string 
+// elements are trimmed in place and std::basic_string_view elements are narrowed
+template <typename Container>                auto trim_all(Container& strs, const std::locale& loc = std::locale{}) -> void;
+template <typename Container, typename Char> auto trim_all(Container& strs, const basic_char_set<Char>& trim_chars) noexcept -> void;
+template <typename Container>                auto trim_all_parallel(Container& strs, const std::locale& loc = std::locale{}, size_t num_threads = 0) -> void; // num_threads = 0 utilizes all hardware threads
+template <typename Container, typename Char> auto trim_all_parallel(Container& strs, const basic_char_set<Char>& trim_chars, size_t num_threads = 0) -> void;
 
 // String - join
 template <typename Strings, typename Str>
 [[nodiscard]] auto join_strings(const Strings& strings, const Str& delimiter) -> std::basic_string<type_traits::underlying_char_t<Str>>;
 template <typename Strings, typename Char = typename Strings::value_type::value_type>
 [[nodiscard]] auto join_strings(const Strings& strings) -> std::basic_string<Char>;
+template <typename Strings, typename Str>
+[[nodiscard]] auto join_strings_parallel(const Strings& strings, const Str& delimiter, size_t num_threads = 0) -> std::basic_string<type_traits::underlying_char_t<Str>>; // num_threads = 0 utilizes all hardware threads
+// String - builder, appends into small-buffer storage and geometrically growing chunks, 
+// finish() makes one contiguous string
+template <typename Char> class basic_string_builder;
+using string_builder = basic_string_builder<char>;
+
+// Joins elements of any range, strings and chars are appended as is, bools as true/false, enums as 
+// their underlying integers and arithmetic values are formatted by std::to_chars. Allocates once.
+// proj(element) selects what is joined of an element, it is invoked twice per element.
+template <typename Range, typename Str>                [[nodiscard]] auto join(const Range& range, const Str& delimiter) -> std::basic_string<type_traits::underlying_char_t<Str>>;
+template <typename Range, typename Str, typename Proj> [[nodiscard]] auto join(const Range& range, const Str& delimiter, const Proj& proj) -> std::basic_string<type_traits::underlying_char_t<Str>>;
 
 // String - case insensitive compare
 template <typename Str0, typename Str1> [[nodiscard]] auto find_ignore_case(const Str0& haystack, const Str1& needle, const std::locale& loc = std::locale{}) noexcept -> size_t;
@@ -69,21 +134,85 @@ template <typename Str0, typename Str1> [[nodiscard]] auto is_equal_ignore_case(
 template <typename Str0, typename Str1> [[nodiscard]] auto contains_substring(const Str0& haystack, const Str1& needle) noexcept -> bool;
 template <typename Str0, typename Str1> [[nodiscard]] auto contains_substring_ignore_case(const Str0& haystack, const Str1& needle, const std::locale& loc = std::locale{}) noexcept -> bool;
 
+// String - case insensitive compare with a case_folder
+template <typename Str0, typename Str1> [[nodiscard]] auto find_ignore_case(const Str0& haystack, const Str1& needle, const case_folder& folder) noexcept -> size_t;
+template <typename Str0, typename Str1> [[nodiscard]] auto find_ignore_case(const Str0& haystack, const Str1& needle, size_t offset, const case_folder& folder) noexcept -> size_t;
+template <typename Str0, typename Str1> [[nodiscard]] auto is_equal_ignore_case(const Str0& a, const Str1& b, const case_folder& folder) noexcept -> bool;
+template <typename Str0, typename Str1> [[nodiscard]] auto contains_substring_ignore_case(const Str0& haystack, const Str1& needle, const case_folder& folder) noexcept -> bool;
+
 // String - case conversion
 template <typename Char>    [[nodiscard]] auto to_lower(std::basic_string<Char> str, const std::locale& loc = std::locale{}) noexcept -> std::basic_string<Char>;
 template <typename Char>    [[nodiscard]] auto to_upper(std::basic_string<Char> str, const std::locale& loc = std::locale{}) noexcept -> std::basic_string<Char>;
 template <typename StrView> [[nodiscard]] auto to_lower(const StrView& str, const std::locale& loc = std::locale{}) -> std::basic_string<type_traits::underlying_char_t<StrView>>;
 template <typename StrView> [[nodiscard]] auto to_upper(const StrView& str, const std::locale& loc = std::locale{}) -> std::basic_string<type_traits::underlying_char_t<StrView>>;
+template <typename Char>    [[nodiscard]] auto to_lower(std::basic_string<Char> str, const case_folder& folder) noexcept -> std::basic_string<Char>;
+template <typename Char>    [[nodiscard]] auto to_upper(std::basic_string<Char> str, const case_folder& folder) noexcept -> std::basic_string<Char>;
+template <typename StrView> [[nodiscard]] auto to_lower(const StrView& str, const case_folder& folder) -> std::basic_string<type_traits::underlying_char_t<StrView>>;
+template <typename StrView> [[nodiscard]] auto to_upper(const StrView& str, const case_folder& folder) -> std::basic_string<type_traits::underlying_char_t<StrView>>;
+
+// String - case insensitive hashing, ASCII letters are folded like the classic locale
+struct hash_ignore_case;
+struct equal_ignore_case;
+template <typename Value> class flat_map_ignore_case; // Open addressing, lookups never allocate
+
+// String - UTF-8 aware simple Unicode case folding, invalid bytes are kept as is
+namespace utf8 {
+[[nodiscard]] inline auto to_lower(std::string_view str) -> std::string;
+[[nodiscard]] inline auto find_ignore_case(std::string_view haystack, std::string_view needle, size_t offset = 0) noexcept -> size_t; // Byte offset of the match
+[[nodiscard]] inline auto is_equal_ignore_case(std::string_view a, std::string_view b) noexcept -> bool;
+}
 
 // String to number conversion
 template <typename T> [[nodiscard]] auto string_to_number(std::string_view str) noexcept -> std::optional<T>;
-template <typename Char = char, typename T> [[nodiscard]] auto number_to_string(const T& number) -> std::basic_string<Char>;
+template <typename Char = char, typename T> [[nodiscard]] auto number_to_string(const T& number) -> std::basic_string<Char>; // Shortest round trip representation
+
+// Number to chars conversion by std::to_chars, for any char type and without allocating. Returns 
+// the end of the written chars, or nullptr if they do not fit. The default format is the shortest 
+// round trip representation, format and precision are as for std::to_chars.
+template <typename Char, typename T> [[nodiscard]] auto number_to_chars(Char* first, Char* last, const T& number) noexcept -> Char*;
+template <typename Char, typename T> [[nodiscard]] auto number_to_chars(Char* first, Char* last, const T& number, std::chars_format format) noexcept -> Char*;
+template <typename Char, typename T> [[nodiscard]] auto number_to_chars(Char* first, Char* last, const T& number, std::chars_format format, int precision) noexcept -> Char*;
+
+// String to number conversion - tokenizes and parses delimited numbers in one pass, parsing 
+// stops at the first invalid token. Tokens are accepted as by string_to_number<T>.
+template <typename T> struct parse_numbers_result {
+	std::vector<T> numbers{};
+	size_t invalid_offset{ std::string_view::npos }; // Offset of the first invalid token, npos if all are valid
+};
+struct parse_numbers_into_result {
+	size_t num_parsed{ 0 };
+	size_t offset{ 0 };       // Offset of the first token not parsed, the size of the text if all are parsed
+	bool is_invalid{ false }; // The token at offset is invalid, otherwise the buffer was full
+};
+template <typename T> [[nodiscard]] auto parse_numbers(std::string_view text, std::string_view delimiters) -> parse_numbers_result<T>;
+template <typename T> [[nodiscard]] auto parse_numbers(std::string_view text, const char_set& delimiters) -> parse_numbers_result<T>;
+template <typename T> [[nodiscard]] auto parse_numbers_into(std::string_view text, std::string_view delimiters, T* dst, size_t dst_size) noexcept -> parse_numbers_into_result;
+template <typename T> [[nodiscard]] auto parse_numbers_into(std::string_view text, const char_set& delimiters, T* dst, size_t dst_size) noexcept -> parse_numbers_into_result;
+
+// Binary to text encoding. Hex is encoded in lowercase and decoded in either case, base64 uses the 
+// standard alphabet with padding. Decoding fails with std::nullopt or nullptr on invalid input.
+[[nodiscard]] inline auto hex_encode(const detail::byte_view& bytes) -> std::string;
+              inline auto hex_encode(const detail::byte_view& bytes, char* dst) noexcept -> char*; // Writes 2 * bytes.size() chars, returns the end
+[[nodiscard]] inline auto hex_decode(std::string_view hex) -> std::optional<std::vector<uint8_t>>;
+[[nodiscard]] inline auto hex_decode(std::string_view hex, uint8_t* dst) noexcept -> uint8_t*; // Writes hex.size() / 2 bytes, returns the end
+[[nodiscard]] inline auto base64_encode(const detail::byte_view& bytes) -> std::string;
+              inline auto base64_encode(const detail::byte_view& bytes, char* dst) noexcept -> char*; // Writes base64_encoded_size(bytes.size()) chars, returns the end
+[[nodiscard]] inline auto base64_decode(std::string_view base64) -> std::optional<std::vector<uint8_t>>;
+[[nodiscard]] inline auto base64_decode(std::string_view base64, uint8_t* dst) noexcept -> uint8_t*; // Writes base64_decoded_size(base64) bytes, returns the end
+[[nodiscard]] constexpr auto base64_encoded_size(size_t num_bytes) noexcept -> size_t;
+[[nodiscard]] constexpr auto base64_decoded_size(std::string_view base64) noexcept -> size_t; // Exact for valid base64
 
 // Scan filesystem
 [[nodiscard]] inline auto list_files_in_directory(const std::filesystem::path& dir) -> std::vector<std::filesystem::path>;
 [[nodiscard]] inline auto list_files_in_directory_tree(const std::filesystem::path& dir) -> std::vector<std::filesystem::path>;
 [[nodiscard]] inline auto list_subdirs_in_directory(const std::filesystem::path& dir) -> std::vector<std::filesystem::path>;
 [[nodiscard]] inline auto list_subdirs_in_directory_tree(const std::filesystem::path& dir) -> std::vector<std::filesystem::path>;
+[[nodiscard]] inline auto expand_glob(const std::filesystem::path& root, std::string_view pattern) -> std::vector<std::filesystem::path>; // Only descends into directories the pattern can match
+
+// Glob patterns, ie "*.log" or "**/cache/*"
+template <bool IgnoreCase> class basic_glob_pattern;
+using glob_pattern = basic_glob_pattern<false>;
+using glob_pattern_ignore_case = basic_glob_pattern<true>; // Folds ASCII letters
 
 
 // Tuple iteration (convenience)
@@ -161,7 +290,68 @@ template <typename T> [[nodiscard]] auto held_type_name(const T& value) -> std::
 	#endif
 #endif
 
+// SIMD kernels are enabled by the instruction sets targeted by the compiler
+#ifndef PRECOOKED_SSE2
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define PRECOOKED_SSE2 1
+	#else
+		#define PRECOOKED_SSE2 0
+	#endif
+#endif
+#ifndef PRECOOKED_SSSE3
+	#if defined(__SSSE3__) || defined(__AVX__)
+		#define PRECOOKED_SSSE3 1
+	#else
+		#define PRECOOKED_SSSE3 0
+	#endif
+#endif
+#ifndef PRECOOKED_AVX2
+	#if defined(__AVX2__)
+		#define PRECOOKED_AVX2 1
+	#else
+		#define PRECOOKED_AVX2 0
+	#endif
+#endif
+#if PRECOOKED_SSE2
+	#include <emmintrin.h>
+#endif
+#if PRECOOKED_SSSE3
+	#include <tmmintrin.h>
+#endif
+#if PRECOOKED_AVX2
+	#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif
+
 #include <type_traits>
+#include <cstdint>
+
+namespace peo::detail {
+// Index of the lowest set bit, bits must not be zero
+[[nodiscard]] inline auto count_trailing_zeros(const uint32_t bits) noexcept -> uint32_t {
+	PRECOOKED_ASSERT(bits != 0);
+#ifdef _MSC_VER
+	unsigned long idx = 0;
+	_BitScanForward(&idx, bits);
+	return static_cast<uint32_t>(idx);
+#else
+	return static_cast<uint32_t>(__builtin_ctz(bits));
+#endif
+}
+// Index of the highest set bit, bits must not be zero
+[[nodiscard]] inline auto index_of_highest_bit(const uint32_t bits) noexcept -> uint32_t {
+	PRECOOKED_ASSERT(bits != 0);
+#ifdef _MSC_VER
+	unsigned long idx = 0;
+	_BitScanReverse(&idx, bits);
+	return static_cast<uint32_t>(idx);
+#else
+	return static_cast<uint32_t>(31 - __builtin_clz(bits));
+#endif
+}
+}
 
 
 class peo::detail::byte_view {
@@ -215,6 +405,78 @@ private:
 };
 }
 
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace peo::detail {
+// Minimum number of elements (chars or strings) for which a parallel 
+// function actually spawns threads
+constexpr auto parallel_min_size = size_t{ 1 } << 18;
+
+// Chunks smaller than this are not worth a task of their own
+constexpr auto parallel_min_chunk_size = size_t{ 1 } << 16;
+
+// num_threads = 0 selects the number of hardware threads
+[[nodiscard]] inline auto resolve_num_threads(const size_t num_threads) noexcept -> size_t {
+	const auto hardware_threads = static_cast<size_t>(std::thread::hardware_concurrency());
+	return 
+		num_threads != 0 ? num_threads : 
+		hardware_threads != 0 ? hardware_threads : 
+		size_t{ 1 };
+}
+
+// Invokes func(task_idx) for every task, distributed over at most num_threads threads 
+// of which the calling thread is one. The first exception thrown by a task is rethrown.
+template <typename Func>
+auto impl_parallel_for(
+	const size_t num_tasks, 
+	const size_t num_threads, 
+	const Func& func
+) -> void {
+	auto next_task = std::atomic<size_t>{ 0 };
+	auto exception = std::exception_ptr{};
+	auto exception_mutex = std::mutex{};
+	const auto worker_f = [&]() noexcept {
+		for (auto task = next_task++; task < num_tasks; task = next_task++) {
+			try {
+				func(task);
+			}
+			catch (...) {
+				const auto lock = std::scoped_lock{ exception_mutex };
+				if (!exception) {
+					exception = std::current_exception();
+				}
+			}
+		}
+	};
+	const auto num_spawned = std::min(num_tasks, num_threads) - std::min(num_tasks, size_t{ 1 });
+	auto threads = std::vector<std::thread>{};
+	threads.reserve(num_spawned);
+	{
+		const auto join_threads = scope_exit{ [&threads]() {
+			for (auto& thread : threads) {
+				thread.join();
+			}
+		} };
+		for (size_t i = 0; i < num_spawned; ++i) {
+			threads.emplace_back(worker_f);
+		}
+		worker_f();
+	}
+	if (exception) {
+		std::rethrow_exception(exception);
+	}
+}
+}
+
+
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
@@ -523,33 +785,207 @@ auto peo::held_type_name(const T& value) -> std::string {
 #include <string_view>
 #include <optional>
 #include <charconv>
+#include <cstring>
+#include <limits>
+
+namespace peo::detail {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr auto is_little_endian = false;
+#else
+constexpr auto is_little_endian = true;
+#endif
+
+[[nodiscard]] constexpr auto is_digit(const char c) noexcept -> bool {
+	return static_cast<unsigned char>(c - '0') < 10;
+}
+
+[[nodiscard]] inline auto load_8_chars(const char* src) noexcept -> uint64_t {
+	auto chars = uint64_t{ 0 };
+	std::memcpy(&chars, src, sizeof(chars));
+	return chars;
+}
+
+// SWAR test of 8 chars loaded little endian, adding 6 carries into the high nibble of chars above '9'
+[[nodiscard]] constexpr auto is_8_digits(const uint64_t chars) noexcept -> bool {
+	return ((chars & 0xf0f0f0f0f0f0f0f0) | (((chars + 0x0606060606060606) & 0xf0f0f0f0f0f0f0f0) >> 4)) == 0x3333333333333333;
+}
+
+// SWAR parse of 8 digits loaded little endian, combines pairs, then quads and then both halves
+[[nodiscard]] constexpr auto parse_8_digits(uint64_t chars) noexcept -> uint32_t {
+	constexpr auto mask = uint64_t{ 0x000000ff000000ff };
+	constexpr auto mul1 = uint64_t{ 100 } + (uint64_t{ 1000000 } << 32);
+	constexpr auto mul2 = uint64_t{ 1 } + (uint64_t{ 10000 } << 32);
+	chars -= 0x3030303030303030;
+	chars = (chars * 10) + (chars >> 8);
+	chars = (((chars & mask) * mul1) + (((chars >> 16) & mask) * mul2)) >> 32;
+	return static_cast<uint32_t>(chars);
+}
+
+// Accumulates up to max_digits digits into value, returns the position after them
+[[nodiscard]] inline auto impl_accumulate_digits(
+	const char* first, 
+	const char* last, 
+	uint64_t& value, 
+	size_t& num_digits,
+	const size_t max_digits
+) noexcept -> const char* {
+	if constexpr (is_little_endian) {
+		while (last - first >= 8 && num_digits + 8 <= max_digits) {
+			const auto chars = load_8_chars(first);
+			if (!is_8_digits(chars)) {
+				break;
+			}
+			value = value * 100000000 + parse_8_digits(chars);
+			num_digits += 8;
+			first += 8;
+		}
+	}
+	for (; first != last && is_digit(*first) && num_digits < max_digits; ++first, ++num_digits) {
+		value = value * 10 + static_cast<uint64_t>(*first - '0');
+	}
+	return first;
+}
+
+// Parses the integer at first as std::from_chars does, returns nullptr if it is invalid or out of range
+template <typename T>
+[[nodiscard]] auto impl_parse_integer(
+	const char* first, 
+	const char* last, 
+	T& value
+) noexcept -> const char* {
+	static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>);
+	const auto is_negative = std::is_signed_v<T> && first != last && *first == '-';
+	first += is_negative ? 1 : 0;
+	const auto* digits_begin = first;
+	for (; first != last && *first == '0'; ++first) {}
+	auto magnitude = uint64_t{ 0 };
+	auto num_digits = size_t{ 0 };
+	// 19 digits can not overflow, a 20th is checked and a 21st always overflows
+	first = impl_accumulate_digits(first, last, magnitude, num_digits, 19);
+	if (first != last && is_digit(*first)) {
+		const auto digit = static_cast<uint64_t>(*first - '0');
+		if (magnitude > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+			return nullptr;
+		}
+		magnitude = magnitude * 10 + digit;
+		++first;
+		if (first != last && is_digit(*first)) {
+			return nullptr;
+		}
+	}
+	if (first == digits_begin) {
+		return nullptr;
+	}
+	using unsigned_t = std::make_unsigned_t<T>;
+	const auto max_magnitude = static_cast<uint64_t>(std::numeric_limits<T>::max()) + (is_negative ? 1 : 0);
+	if (magnitude > max_magnitude) {
+		return nullptr;
+	}
+	value = is_negative ?
+		static_cast<T>(static_cast<unsigned_t>(0 - magnitude)) :
+		static_cast<T>(magnitude);
+	return first;
+}
+}
 
 template <typename T>
 auto peo::string_to_number(const std::string_view str) noexcept -> std::optional<T> {
 	static_assert(std::is_arithmetic_v<T>, "T needs to be an arithmetic type");
 	auto value = T{};
 	const auto* ptr_end = str.data() + str.size();
-	const auto result = std::from_chars(str.data(), ptr_end, value);
-	const auto success = 
-		result.ec == std::errc{} &&
-		result.ptr == ptr_end;
-	return success ? value : std::optional<T>{};
+	if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+		const auto* parsed_end = detail::impl_parse_integer(str.data(), ptr_end, value);
+		const auto success = parsed_end != nullptr && parsed_end == ptr_end;
+		return success ? value : std::optional<T>{};
+	}
+	else {
+		const auto result = std::from_chars(str.data(), ptr_end, value);
+		const auto success = 
+			result.ec == std::errc{} &&
+			result.ptr == ptr_end;
+		return success ? value : std::optional<T>{};
+	}
 }
 
-template <typename Char, typename T> 
-auto peo::number_to_string(const T& number) -> std::basic_string<Char> {
+namespace peo::detail {
+// Chars wider than char are formatted as chars into the bytes of the destination, 
+// and then widened in place from back to front. A widened char only overwrites 
+// bytes of chars which are already widened.
+template <typename Char, typename T, typename... FormatArgs>
+[[nodiscard]] auto impl_number_to_chars(
+	Char* first, 
+	Char* last, 
+	const T number, 
+	const FormatArgs... format_args
+) noexcept -> Char* {
+	static_assert(type_traits::is_valid_char_v<Char>);
 	static_assert(std::is_arithmetic_v<T>, "T needs to be an arithmetic type");
-	if constexpr (std::is_same_v<Char, char>) {
-		return std::to_string(number);
+	if constexpr (std::is_same_v<T, bool>) {
+		return impl_number_to_chars(first, last, static_cast<int>(number), format_args...);
 	}
-	else if constexpr (std::is_same_v<Char, wchar_t>) {
-		return std::to_wstring(number);
+	else if constexpr (std::is_same_v<Char, char>) {
+		const auto converted = std::to_chars(first, last, number, format_args...);
+		return converted.ec == std::errc{} ? converted.ptr : nullptr;
 	}
 	else {
-		auto stru8 = std::to_string(number);
-		return std::basic_string<Char>(stru8.begin(), stru8.end());
+		static_assert(sizeof(Char) > sizeof(char));
+		auto* bytes = reinterpret_cast<char*>(first);
+		const auto capacity = static_cast<size_t>(last - first);
+		const auto converted = std::to_chars(bytes, bytes + capacity, number, format_args...);
+		if (converted.ec != std::errc{}) {
+			return nullptr;
+		}
+		const auto num_chars = static_cast<size_t>(converted.ptr - bytes);
+		for (auto i = num_chars; i-- > 0;) {
+			first[i] = static_cast<Char>(bytes[i]);
+		}
+		return first + num_chars;
 	}
 }
+}
+
+template <typename Char, typename T>
+auto peo::number_to_chars(
+	Char* first, 
+	Char* last, 
+	const T& number
+) noexcept -> Char* {
+	return detail::impl_number_to_chars(first, last, number);
+}
+
+template <typename Char, typename T>
+auto peo::number_to_chars(
+	Char* first, 
+	Char* last, 
+	const T& number, 
+	const std::chars_format format
+) noexcept -> Char* {
+	static_assert(std::is_floating_point_v<T>, "A format requires a floating point type");
+	return detail::impl_number_to_chars(first, last, number, format);
+}
+
+template <typename Char, typename T>
+auto peo::number_to_chars(
+	Char* first, 
+	Char* last, 
+	const T& number, 
+	const std::chars_format format, 
+	const int precision
+) noexcept -> Char* {
+	static_assert(std::is_floating_point_v<T>, "A format requires a floating point type");
+	return detail::impl_number_to_chars(first, last, number, format, precision);
+}
+
+template <typename Char, typename T> 
+auto peo::number_to_string(const T& number) -> std::basic_string<Char> {
+	static_assert(std::is_arithmetic_v<T>, "T needs to be an arithmetic type");
+	// Fits the shortest representation of any arithmetic type
+	auto buffer = std::array<Char, 64>{};
+	const auto* end = number_to_chars(buffer.data(), buffer.data() + buffer.size(), number);
+	PRECOOKED_ASSERT(end != nullptr);
+	return std::basic_string<Char>(buffer.data(), static_cast<size_t>(end - buffer.data()));
+}
 
 
 
@@ -559,168 +995,155 @@ auto peo::number_to_string(const T& number) -> std::basic_string<Char> {
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
 
-#include <string>
-#include <string_view>
-#include <type_traits>
-#include <sstream>
-
-
-namespace peo::detail {
-using hexchars_t = std::array<char, 2>;
-[[nodiscard]] inline auto uint8_to_hexchars(
-	const uint8_t value
-) noexcept -> hexchars_t {
-	static_assert(std::is_same_v<std::string::value_type, char>);
-	auto hex_digit_f = [](const uint8_t v) noexcept -> char {
-		constexpr auto digits = std::string_view{ "0123456789abcdef" };
-		PRECOOKED_ASSERT(v < digits.size());
-		return digits[v];
-	};
-	const auto left_digit = hex_digit_f(value / 16);
-	const auto right_digit = hex_digit_f(value % 16);
-	return hexchars_t{ left_digit, right_digit };
-};
-}
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <vector>
 
-template <typename T>
-auto peo::pretty_string(const T& value) -> std::string {
-	using value_t = std::decay_t<T>;
-	using namespace std::string_literals;
-	if constexpr (std::is_same_v<std::string, value_t>) {
-		return value;
-	}
-	else if constexpr (std::is_same_v<std::string_view, value_t>) {
-		return std::string{ value };
-	}
-	else if constexpr (type_traits::is_string_v<value_t>) {
-		auto str = std::string{};
-		str.resize(value.size());
-		using src_char_t = type_traits::underlying_char_t<T>;
-		using dst_char_t = std::string::value_type;
-		const auto truncate_to_dst_char_f = [](const src_char_t& src_char) noexcept -> dst_char_t {
-			const auto dst_char = static_cast<dst_char_t>(src_char);
-			const auto is_truncated = static_cast<src_char_t>(dst_char) != src_char;
-			return is_truncated ?
-				dst_char_t{ '?' } :
-				dst_char;
-		};
-		std::transform(value.begin(), value.end(), str.begin(), truncate_to_dst_char_f);
-		return str;
+// Chars are appended to the inline buffer until it is full, then to chunks whose capacities 
+// grow with the total size. Chunks never reallocate, so appended chars are copied once into 
+// the chunks and once more by finish(). A builder whose content is a single reserved chunk 
+// hands it over without copying.
+template <typename Char>
+class peo::basic_string_builder {
+public:
+	static_assert(type_traits::is_valid_char_v<Char>);
+	static constexpr auto inline_capacity = size_t{ 128 };
+	basic_string_builder() noexcept = default;
+	explicit basic_string_builder(const size_t capacity) {
+		reserve(capacity);
 	}
-	else if constexpr (std::is_same_v<bool, value_t>) {
-		return value ? "true"s : "false"s;
+	// Following appends up to a total size of capacity do not allocate
+	auto reserve(const size_t capacity) -> void {
+		const auto total_capacity = size_ + free_capacity();
+		if (capacity > total_capacity) {
+			add_chunk(capacity - size_);
+		}
 	}
-	else if constexpr (std::is_arithmetic_v<value_t>) {
-		return std::to_string(value);
+	auto append(const std::basic_string_view<Char> sv) -> basic_string_builder& {
+		auto rest = sv;
+		while (!rest.empty()) {
+			const auto num_chars = std::min(rest.size(), reserve_free_capacity(1, rest.size()));
+			write(rest.substr(0, num_chars));
+			rest.remove_prefix(num_chars);
+		}
+		return *this;
 	}
-	else if constexpr (type_traits::is_smart_ptr_v<value_t>) {
-		return value == nullptr ? 
-			"nullptr"s : 
-			pretty_string(*value);
+	auto append(const Char c) -> basic_string_builder& {
+		reserve_free_capacity(1, 1);
+		write(std::basic_string_view<Char>{ &c, 1 });
+		return *this;
 	}
-	else if constexpr (type_traits::is_weak_ptr_v<value_t>) {
-		auto sptr = value.lock();
-		return pretty_string(sptr);
+	auto append_repeat(const Char c, size_t count) -> basic_string_builder& {
+		while (count > 0) {
+			const auto num_chars = std::min(count, reserve_free_capacity(1, count));
+			auto* dst = grow_region(num_chars);
+			std::fill(dst, dst + num_chars, c);
+			count -= num_chars;
+		}
+		return *this;
 	}
-	else if constexpr (
-		std::is_pointer_v<value_t> && 
-		!type_traits::is_valid_char_v<std::remove_pointer_t<value_t>>
-	) {
-		return value == nullptr ?
-			"nullptr"s :
-			pretty_string(*value);
+	auto append_repeat(const std::basic_string_view<Char> sv, const size_t count) -> basic_string_builder& {
+		reserve(size_ + sv.size() * count);
+		for (size_t i = 0; i < count; ++i) {
+			append(sv);
+		}
+		return *this;
 	}
-	else if constexpr (type_traits::is_variant_v<value_t>) {
-		return std::visit([](auto&& candidate) {
-			return pretty_string(candidate);
-		}, value);
+	// Formats by std::to_chars, format_args are passed on, ie std::chars_format::fixed and a precision
+	template <typename T, typename... FormatArgs>
+	auto append_number(const T value, const FormatArgs... format_args) -> basic_string_builder& {
+		static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "T needs to be an arithmetic type");
+		constexpr auto max_short_size = size_t{ 64 };
+		reserve_free_capacity(max_short_size, max_short_size);
+		auto* first = grow_region(max_short_size);
+		if (const auto* end = detail::impl_number_to_chars(first, first + max_short_size, value, format_args...); end != nullptr) PRECOOKED_LIKELY {
+			shrink_region(max_short_size - static_cast<size_t>(end - first));
+			return *this;
+		}
+		shrink_region(max_short_size);
+		// Long fixed representations of floating point values
+		auto buffer = std::vector<Char>(max_short_size * 8);
+		for (;; buffer.resize(buffer.size() * 2)) {
+			if (const auto* end = detail::impl_number_to_chars(buffer.data(), buffer.data() + buffer.size(), value, format_args...); end != nullptr) {
+				return append(std::basic_string_view<Char>{ buffer.data(), static_cast<size_t>(end - buffer.data()) });
+			}
+		}
 	}
-	else if constexpr (type_traits::is_optional_v<value_t>) {
-		return value.has_value() ?
-			pretty_string(*value) :
-			"std::nullopt"s;
+	[[nodiscard]] auto size() const noexcept -> size_t { return size_; }
+	[[nodiscard]] auto empty() const noexcept -> bool { return size_ == 0; }
+	auto clear() noexcept -> void {
+		inline_size_ = 0;
+		chunks_.clear();
+		size_ = 0;
 	}
-	else if constexpr (std::is_same_v<std::any, value_t>) {
-		return value.empty() ?
-			"empty std::any"s :
-			"std::any containing type "s + held_type_name(value);
+	// Leaves the builder empty
+	[[nodiscard]] auto finish() -> std::basic_string<Char> {
+		if (inline_size_ == 0 && chunks_.size() == 1) {
+			auto str = std::move(chunks_.front());
+			clear();
+			return str;
+		}
+		auto str = std::basic_string<Char>{};
+		str.reserve(size_);
+		str.append(inline_.data(), inline_size_);
+		for (const auto& chunk : chunks_) {
+			str.append(chunk);
+		}
+		PRECOOKED_ASSERT(str.size() == size_);
+		clear();
+		return str;
 	}
-	else if constexpr (std::is_base_of_v<std::exception, value_t>) {
-		return value.what();
+private:
+	[[nodiscard]] auto free_capacity() const noexcept -> size_t {
+		return chunks_.empty() ?
+			inline_capacity - inline_size_ :
+			chunks_.back().capacity() - chunks_.back().size();
 	}
-	else if constexpr (type_traits::has_ostream_v<value_t>) {
-		auto sstr = std::ostringstream{};
-		sstr << value;
-		return sstr.str();
+	auto add_chunk(const size_t min_capacity) -> void {
+		auto& chunk = chunks_.emplace_back();
+		chunk.reserve(std::max(min_capacity, size_ + inline_capacity));
 	}
-	else if constexpr (type_traits::is_container_v<value_t>) {
-		auto str = std::string{};
-		const auto estimate_size = value.size() * 4;
-		str.reserve(estimate_size);
-		str += '[';
-		for (auto&& element : value) {
-			str += pretty_string(element);
-			str += ' ';
+	// Adds a chunk unless min_free chars fit, returns the free capacity, 
+	// the size of a new chunk is based on the wanted number of chars
+	auto reserve_free_capacity(const size_t min_free, const size_t wanted) -> size_t {
+		if (free_capacity() < min_free) {
+			add_chunk(wanted);
 		}
-		if (str.size() == 1) {
-			str.push_back(']');
-		}
-		else {
-			str.back() = ']';
+		PRECOOKED_ASSERT(free_capacity() >= min_free);
+		return free_capacity();
+	}
+	// Returns the position of num_chars appended chars to write, the chars must fit
+	auto grow_region(const size_t num_chars) -> Char* {
+		PRECOOKED_ASSERT(num_chars <= free_capacity());
+		size_ += num_chars;
+		if (chunks_.empty()) {
+			auto* dst = inline_.data() + inline_size_;
+			inline_size_ += num_chars;
+			return dst;
 		}
-		return str;
+		auto& chunk = chunks_.back();
+		const auto offset = chunk.size();
+		chunk.resize(offset + num_chars);
+		return chunk.data() + offset;
 	}
-	else if constexpr(type_traits::is_tuple_v<value_t>){
-		auto str = std::string{};
-		const auto estimate_size = std::tuple_size_v<value_t> * 4;
-		str.reserve(estimate_size);
-		str += '[';
-		tuple_for_each(value, [&str](auto&& elem) {
-			str += pretty_string(elem);
-			str += ' '; 
-		});
-		if (str.size() == 1) {
-			str.push_back(']');
+	auto shrink_region(const size_t num_chars) noexcept -> void {
+		size_ -= num_chars;
+		if (chunks_.empty()) {
+			inline_size_ -= num_chars;
 		}
 		else {
-			str.back() = ']';
+			chunks_.back().resize(chunks_.back().size() - num_chars);
 		}
-		return str;
-	}
-	else if constexpr (std::is_enum_v<value_t>) {
-		using underlying_type = std::underlying_type_t<T>;
-		return pretty_string(static_cast<underlying_type>(value));
-	}
-	else if constexpr (type_traits::is_duration_v<value_t>) {
-		return pretty_string(value.count());
 	}
-	else {
-		const auto* first = reinterpret_cast<const uint8_t*>(&value);
-		const auto* last = first + sizeof(value);
-		constexpr auto prologue = std::string_view{ "unknown 0x" };
-		const auto target_size =
-			prologue.size() +
-			(last - first) * 2;
-		auto str = std::string{};
-		str.reserve(target_size);
-		str += prologue;
-		for (auto it = first; it < last; ++it) {
-			const auto hexchars = detail::uint8_to_hexchars(*it);
-			str += hexchars[0];
-			str += hexchars[1];
-		}
-		PRECOOKED_ASSERT(target_size == str.size());
-		return str;
+	auto write(const std::basic_string_view<Char> sv) -> void {
+		std::copy(sv.begin(), sv.end(), grow_region(sv.size()));
 	}
-
-}
-
-
-
-
-
-
-
+	std::array<Char, inline_capacity> inline_{};
+	size_t inline_size_{ 0 };
+	std::vector<std::basic_string<Char>> chunks_{};
+	size_t size_{ 0 };
+};
 
 
 
@@ -730,138 +1153,662 @@ auto peo::pretty_string(const T& value) -> std::string {
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
 
-#include <numeric>
-
+#include <array>
+#include <optional>
+#include <vector>
 
 namespace peo::detail {
-template <typename Strings, typename Char>
-[[nodiscard]] auto impl_join_strings(
-	const Strings& strings, 
-	const std::basic_string_view<Char>& delimiter
-) -> std::basic_string<Char> {
-	if (strings.empty()) PRECOOKED_UNLIKELY {
-		return {};
+
+constexpr auto hex_digits = std::string_view{ "0123456789abcdef" };
+constexpr auto base64_alphabet = std::string_view{ "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/" };
+
+// Value of a hex or base64 char, -1 if it is not part of the alphabet
+template <bool IsBase64>
+constexpr auto decode_table = []() {
+	auto table = std::array<int8_t, 256>{};
+	for (auto& value : table) {
+		value = -1;
 	}
-	const auto target_size_of_strings = std::accumulate(
-		strings.begin(), 
-		strings.end(), 
-		size_t{ 0 }, 
-		[](const size_t sum, const auto& str) noexcept -> size_t {
-			return sum + str.size();
-		}
-	);
-	PRECOOKED_ASSERT(!strings.empty());
-	const auto num_delimiters = strings.size() - 1;
-	const auto target_size_of_delimiters = num_delimiters * delimiter.size();
-	const auto target_size = target_size_of_strings + target_size_of_delimiters;
-	// Merge strings
-	auto joined = std::basic_string<Char>{};
-	joined.reserve(target_size);
-	if (delimiter.empty()) {
-		// No delimiter
-		for (auto&& str : strings) {
-			joined.append(str);
+	if constexpr (IsBase64) {
+		for (size_t i = 0; i < base64_alphabet.size(); ++i) {
+			table[static_cast<uint8_t>(base64_alphabet[i])] = static_cast<int8_t>(i);
 		}
 	}
 	else {
-		PRECOOKED_ASSERT(!strings.empty());
-		// Intersperse delimiter
-		for (
-			auto it = strings.begin(), it_end = std::prev(strings.end()); 
-			it != it_end; 
-			++it
-		) {
-			joined.append(*it);
-			joined.append(delimiter);
+		for (size_t i = 0; i < hex_digits.size(); ++i) {
+			table[static_cast<uint8_t>(hex_digits[i])] = static_cast<int8_t>(i);
+		}
+		for (auto c = 'A'; c <= 'F'; ++c) {
+			table[static_cast<uint8_t>(c)] = static_cast<int8_t>(c - 'A' + 10);
 		}
-		joined.append(strings.back());
-		// No delimiter at end
 	}
-	PRECOOKED_ASSERT(joined.size() == target_size);
-	return joined;
-}
+	return table;
+}();
+
+#if PRECOOKED_SSE2
+// Hex digits of the nibbles, n + '0' below ten and n + 'a' - 10 above
+[[nodiscard]] inline auto impl_hex_digits_sse2(const __m128i nibbles) noexcept -> __m128i {
+	const auto is_letter = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+	const auto offsets = _mm_add_epi8(
+		_mm_set1_epi8('0'), 
+		_mm_and_si128(is_letter, _mm_set1_epi8('a' - '0' - 10))
+	);
+	return _mm_add_epi8(nibbles, offsets);
 }
 
-template <typename Strings, typename Str>
-auto peo::join_strings(
-	const Strings& strings, 
-	const Str& delimiter
-) -> std::basic_string<type_traits::underlying_char_t<Str>> {
-	using Char = type_traits::underlying_char_t<Str>;
-	static_assert(type_traits::is_valid_char_v<Char>);
-	return detail::impl_join_strings(strings, std::basic_string_view<Char>{delimiter});
+// Values of 16 hex chars, returns false if any char is not a hex digit
+[[nodiscard]] inline auto impl_hex_values_sse2(const __m128i chars, __m128i& values) noexcept -> bool {
+	const auto in_range_f = [](const __m128i v, const char first, const char num) noexcept {
+		const auto offset = _mm_sub_epi8(v, _mm_set1_epi8(first));
+		return _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(static_cast<char>(num - 1))), offset);
+	};
+	const auto lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+	const auto is_digit = in_range_f(chars, '0', 10);
+	const auto is_letter = in_range_f(lower, 'a', 6);
+	if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) != 0xffff) {
+		return false;
+	}
+	values = _mm_or_si128(
+		_mm_and_si128(is_digit, _mm_sub_epi8(chars, _mm_set1_epi8('0'))),
+		_mm_andnot_si128(is_digit, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10)))
+	);
+	return true;
 }
 
-template <typename Strings, typename Char>
-auto peo::join_strings(const Strings& strings) -> std::basic_string<Char> {
-	static_assert(type_traits::is_valid_char_v<Char>);
-	return detail::impl_join_strings(strings, std::basic_string_view<Char>{});
+// Combines the pairs of nibble values into 8 bytes in the low half
+[[nodiscard]] inline auto impl_hex_pack_sse2(const __m128i values) noexcept -> __m128i {
+	const auto high_nibbles = _mm_slli_epi16(_mm_and_si128(values, _mm_set1_epi16(0x00ff)), 4);
+	const auto low_nibbles = _mm_srli_epi16(values, 8);
+	return _mm_or_si128(high_nibbles, low_nibbles);
 }
+#endif
 
+[[nodiscard]] inline auto impl_hex_encode(
+	const uint8_t* src, 
+	const size_t size, 
+	char* dst
+) noexcept -> char* {
+	auto i = size_t{ 0 };
+#if PRECOOKED_AVX2
+	for (; i + 32 <= size; i += 32) {
+		const auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+		const auto nibble_mask = _mm256_set1_epi8(0x0f);
+		const auto high = _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibble_mask);
+		const auto low = _mm256_and_si256(bytes, nibble_mask);
+		const auto digits_f = [](const __m256i nibbles) noexcept {
+			const auto is_letter = _mm256_cmpgt_epi8(nibbles, _mm256_set1_epi8(9));
+			const auto offsets = _mm256_add_epi8(
+				_mm256_set1_epi8('0'),
+				_mm256_and_si256(is_letter, _mm256_set1_epi8('a' - '0' - 10))
+			);
+			return _mm256_add_epi8(nibbles, offsets);
+		};
+		const auto high_digits = digits_f(high);
+		const auto low_digits = digits_f(low);
+		// Unpacking interleaves within lanes, the lanes are then put in order
+		const auto first = _mm256_unpacklo_epi8(high_digits, low_digits);
+		const auto second = _mm256_unpackhi_epi8(high_digits, low_digits);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_permute2x128_si256(first, second, 0x20));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32), _mm256_permute2x128_si256(first, second, 0x31));
+		dst += 64;
+	}
+#endif
+#if PRECOOKED_SSE2
+	for (; i + 16 <= size; i += 16) {
+		const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		const auto nibble_mask = _mm_set1_epi8(0x0f);
+		const auto high_digits = impl_hex_digits_sse2(_mm_and_si128(_mm_srli_epi16(bytes, 4), nibble_mask));
+		const auto low_digits = impl_hex_digits_sse2(_mm_and_si128(bytes, nibble_mask));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi8(high_digits, low_digits));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpackhi_epi8(high_digits, low_digits));
+		dst += 32;
+	}
+#endif
+	for (; i < size; ++i) {
+		*dst++ = hex_digits[src[i] >> 4];
+		*dst++ = hex_digits[src[i] & 0x0f];
+	}
+	return dst;
+}
 
+[[nodiscard]] inline auto impl_hex_decode(
+	const std::string_view hex, 
+	uint8_t* dst
+) noexcept -> uint8_t* {
+	if (hex.size() % 2 != 0) {
+		return nullptr;
+	}
+	auto i = size_t{ 0 };
+#if PRECOOKED_SSE2
+	for (; i + 32 <= hex.size(); i += 32) {
+		auto values0 = __m128i{};
+		auto values1 = __m128i{};
+		const auto is_valid = 
+			impl_hex_values_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex.data() + i)), values0) &&
+			impl_hex_values_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex.data() + i + 16)), values1);
+		if (!is_valid) {
+			return nullptr;
+		}
+		const auto bytes = _mm_packus_epi16(impl_hex_pack_sse2(values0), impl_hex_pack_sse2(values1));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), bytes);
+		dst += 16;
+	}
+#endif
+	const auto& table = decode_table<false>;
+	for (; i < hex.size(); i += 2) {
+		const auto high = table[static_cast<uint8_t>(hex[i])];
+		const auto low = table[static_cast<uint8_t>(hex[i + 1])];
+		if ((high | low) < 0) {
+			return nullptr;
+		}
+		*dst++ = static_cast<uint8_t>((high << 4) | low);
+	}
+	return dst;
+}
 
+#if PRECOOKED_SSSE3
+// Spreads the 12 bytes in the low part of the block to 16 six-bit values, 
+// every 32-bit lane holds 3 bytes as 4 values
+[[nodiscard]] inline auto impl_base64_split_ssse3(const __m128i bytes) noexcept -> __m128i {
+	const auto shuffled = _mm_shuffle_epi8(bytes, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+	const auto high = _mm_mulhi_epu16(
+		_mm_and_si128(shuffled, _mm_set1_epi32(0x0fc0fc00)), 
+		_mm_set1_epi32(0x04000040)
+	);
+	const auto low = _mm_mullo_epi16(
+		_mm_and_si128(shuffled, _mm_set1_epi32(0x003f03f0)), 
+		_mm_set1_epi32(0x01000010)
+	);
+	return _mm_or_si128(high, low);
+}
 
+// Base64 chars of six-bit values, the offset to add is looked up by the range of the value
+[[nodiscard]] inline auto impl_base64_chars_ssse3(const __m128i values) noexcept -> __m128i {
+	auto ranges = _mm_subs_epu8(values, _mm_set1_epi8(51));
+	const auto is_upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), values);
+	ranges = _mm_or_si128(ranges, _mm_and_si128(is_upper, _mm_set1_epi8(13)));
+	const auto offsets = _mm_setr_epi8(
+		'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, 
+		'0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0
+	);
+	return _mm_add_epi8(values, _mm_shuffle_epi8(offsets, ranges));
+}
 
+// Six-bit values of 16 base64 chars, returns false if any char is not in the alphabet. 
+// The nibble tables flag the chars outside of the alphabet, and the high nibble 
+// selects the offset from char to value, '/' shares the high nibble with '+'.
+[[nodiscard]] inline auto impl_base64_values_ssse3(const __m128i chars, __m128i& values) noexcept -> bool {
+	const auto nibble_mask = _mm_set1_epi8(0x0f);
+	const auto high_nibbles = _mm_and_si128(_mm_srli_epi32(chars, 4), nibble_mask);
+	const auto low_nibbles = _mm_and_si128(chars, nibble_mask);
+	const auto low_flags = _mm_shuffle_epi8(_mm_setr_epi8(
+		0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a
+	), low_nibbles);
+	const auto high_flags = _mm_shuffle_epi8(_mm_setr_epi8(
+		0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+	), high_nibbles);
+	const auto is_valid = _mm_cmpeq_epi8(_mm_and_si128(low_flags, high_flags), _mm_setzero_si128());
+	if (_mm_movemask_epi8(is_valid) != 0xffff) {
+		return false;
+	}
+	const auto is_slash = _mm_cmpeq_epi8(chars, _mm_set1_epi8('/'));
+	const auto offsets = _mm_shuffle_epi8(_mm_setr_epi8(
+		0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0
+	), _mm_add_epi8(is_slash, high_nibbles));
+	values = _mm_add_epi8(chars, offsets);
+	return true;
+}
 
+// Packs 16 six-bit values into 12 bytes in the low part of the block
+[[nodiscard]] inline auto impl_base64_pack_ssse3(const __m128i values) noexcept -> __m128i {
+	const auto pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+	const auto triples = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+	return _mm_shuffle_epi8(triples, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+#endif
 
+[[nodiscard]] inline auto impl_base64_encode(
+	const uint8_t* src, 
+	const size_t size, 
+	char* dst
+) noexcept -> char* {
+	auto i = size_t{ 0 };
+#if PRECOOKED_AVX2
+	// Every lane encodes 12 bytes, the loads read 4 bytes beyond them
+	for (; i + 28 <= size; i += 24) {
+		const auto bytes = _mm256_inserti128_si256(
+			_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12)),
+			1
+		);
+		const auto split_f = [](const __m256i in) noexcept {
+			const auto shuffled = _mm256_shuffle_epi8(in, _mm256_setr_epi8(
+				1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+				1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10
+			));
+			const auto high = _mm256_mulhi_epu16(
+				_mm256_and_si256(shuffled, _mm256_set1_epi32(0x0fc0fc00)), 
+				_mm256_set1_epi32(0x04000040)
+			);
+			const auto low = _mm256_mullo_epi16(
+				_mm256_and_si256(shuffled, _mm256_set1_epi32(0x003f03f0)), 
+				_mm256_set1_epi32(0x01000010)
+			);
+			return _mm256_or_si256(high, low);
+		};
+		const auto values = split_f(bytes);
+		auto ranges = _mm256_subs_epu8(values, _mm256_set1_epi8(51));
+		const auto is_upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), values);
+		ranges = _mm256_or_si256(ranges, _mm256_and_si256(is_upper, _mm256_set1_epi8(13)));
+		const auto offsets = _mm256_setr_epi8(
+			'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, 
+			'0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+			'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, 
+			'0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0
+		);
+		const auto chars = _mm256_add_epi8(values, _mm256_shuffle_epi8(offsets, ranges));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), chars);
+		dst += 32;
+	}
+#endif
+#if PRECOOKED_SSSE3
+	// Encodes 12 bytes, the load reads 4 bytes beyond them
+	for (; i + 16 <= size; i += 12) {
+		const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		const auto chars = impl_base64_chars_ssse3(impl_base64_split_ssse3(bytes));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), chars);
+		dst += 16;
+	}
+#endif
+	for (; i + 3 <= size; i += 3) {
+		const auto triple = (uint32_t{ src[i] } << 16) | (uint32_t{ src[i + 1] } << 8) | uint32_t{ src[i + 2] };
+		*dst++ = base64_alphabet[(triple >> 18) & 0x3f];
+		*dst++ = base64_alphabet[(triple >> 12) & 0x3f];
+		*dst++ = base64_alphabet[(triple >> 6) & 0x3f];
+		*dst++ = base64_alphabet[triple & 0x3f];
+	}
+	if (const auto num_left = size - i; num_left > 0) {
+		const auto triple = 
+			(uint32_t{ src[i] } << 16) | 
+			(num_left == 2 ? uint32_t{ src[i + 1] } << 8 : 0);
+		*dst++ = base64_alphabet[(triple >> 18) & 0x3f];
+		*dst++ = base64_alphabet[(triple >> 12) & 0x3f];
+		*dst++ = num_left == 2 ? base64_alphabet[(triple >> 6) & 0x3f] : '=';
+		*dst++ = '=';
+	}
+	return dst;
+}
 
+[[nodiscard]] inline auto impl_base64_decode(
+	const std::string_view base64, 
+	uint8_t* dst
+) noexcept -> uint8_t* {
+	if (base64.size() % 4 != 0) {
+		return nullptr;
+	}
+	auto i = size_t{ 0 };
+#if PRECOOKED_SSSE3
+	// Decodes 16 chars to 12 bytes and stores 16, at least 8 chars are left, 
+	// which decode to at least the 4 bytes beyond
+	for (; i + 24 <= base64.size(); i += 16) {
+		auto values = __m128i{};
+		if (!impl_base64_values_ssse3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(base64.data() + i)), values)) {
+			return nullptr;
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), impl_base64_pack_ssse3(values));
+		dst += 12;
+	}
+#endif
+	const auto& table = decode_table<true>;
+	const auto num_full_groups_end = base64.size() - (base64.empty() ? 0 : 4);
+	for (; i < num_full_groups_end; i += 4) {
+		const auto a = table[static_cast<uint8_t>(base64[i])];
+		const auto b = table[static_cast<uint8_t>(base64[i + 1])];
+		const auto c = table[static_cast<uint8_t>(base64[i + 2])];
+		const auto d = table[static_cast<uint8_t>(base64[i + 3])];
+		if ((a | b | c | d) < 0) {
+			return nullptr;
+		}
+		const auto triple = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | uint32_t(d);
+		*dst++ = static_cast<uint8_t>(triple >> 16);
+		*dst++ = static_cast<uint8_t>(triple >> 8);
+		*dst++ = static_cast<uint8_t>(triple);
+	}
+	if (base64.empty()) {
+		return dst;
+	}
+	// The last group may be padded
+	const auto num_padding = 
+		base64[i + 3] != '=' ? 0 : 
+		base64[i + 2] != '=' ? 1 : 
+		2;
+	const auto a = table[static_cast<uint8_t>(base64[i])];
+	const auto b = table[static_cast<uint8_t>(base64[i + 1])];
+	const auto c = num_padding >= 2 ? int8_t{ 0 } : table[static_cast<uint8_t>(base64[i + 2])];
+	const auto d = num_padding >= 1 ? int8_t{ 0 } : table[static_cast<uint8_t>(base64[i + 3])];
+	if ((a | b | c | d) < 0) {
+		return nullptr;
+	}
+	const auto triple = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | uint32_t(d);
+	*dst++ = static_cast<uint8_t>(triple >> 16);
+	if (num_padding < 2) {
+		*dst++ = static_cast<uint8_t>(triple >> 8);
+	}
+	if (num_padding < 1) {
+		*dst++ = static_cast<uint8_t>(triple);
+	}
+	return dst;
+}
 
+}
 
+auto peo::hex_encode(const detail::byte_view& bytes, char* dst) noexcept -> char* {
+	return detail::impl_hex_encode(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size(), dst);
+}
 
+auto peo::hex_encode(const detail::byte_view& bytes) -> std::string {
+	auto hex = std::string{};
+	hex.resize(bytes.size() * 2);
+	[[maybe_unused]] const auto* end = hex_encode(bytes, hex.data());
+	PRECOOKED_ASSERT(end == hex.data() + hex.size());
+	return hex;
+}
 
+auto peo::hex_decode(const std::string_view hex, uint8_t* dst) noexcept -> uint8_t* {
+	return detail::impl_hex_decode(hex, dst);
+}
 
+auto peo::hex_decode(const std::string_view hex) -> std::optional<std::vector<uint8_t>> {
+	if (hex.empty()) {
+		return std::vector<uint8_t>{};
+	}
+	auto bytes = std::vector<uint8_t>(hex.size() / 2);
+	if (hex_decode(hex, bytes.data()) == nullptr) {
+		return std::nullopt;
+	}
+	return bytes;
+}
 
+constexpr auto peo::base64_encoded_size(const size_t num_bytes) noexcept -> size_t {
+	return (num_bytes + 2) / 3 * 4;
+}
 
+constexpr auto peo::base64_decoded_size(const std::string_view base64) noexcept -> size_t {
+	const auto num_padding = 
+		base64.size() >= 2 && base64[base64.size() - 2] == '=' ? 2 : 
+		!base64.empty() && base64.back() == '=' ? 1 : 
+		0;
+	return base64.size() / 4 * 3 - (base64.size() >= 4 ? num_padding : 0);
+}
 
+auto peo::base64_encode(const detail::byte_view& bytes, char* dst) noexcept -> char* {
+	return detail::impl_base64_encode(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size(), dst);
+}
 
+auto peo::base64_encode(const detail::byte_view& bytes) -> std::string {
+	auto base64 = std::string{};
+	base64.resize(base64_encoded_size(bytes.size()));
+	[[maybe_unused]] const auto* end = base64_encode(bytes, base64.data());
+	PRECOOKED_ASSERT(end == base64.data() + base64.size());
+	return base64;
+}
 
+auto peo::base64_decode(const std::string_view base64, uint8_t* dst) noexcept -> uint8_t* {
+	return detail::impl_base64_decode(base64, dst);
+}
 
+auto peo::base64_decode(const std::string_view base64) -> std::optional<std::vector<uint8_t>> {
+	if (base64.empty()) {
+		return std::vector<uint8_t>{};
+	}
+	auto bytes = std::vector<uint8_t>(base64_decoded_size(base64));
+	if (base64_decode(base64, bytes.data()) == nullptr) {
+		return std::nullopt;
+	}
+	return bytes;
+}
 
 
 
 
 
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <array>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <sstream>
 
 
+namespace peo::detail {
+using hexchars_t = std::array<char, 2>;
+[[nodiscard]] inline auto uint8_to_hexchars(
+	const uint8_t value
+) noexcept -> hexchars_t {
+	static_assert(std::is_same_v<std::string::value_type, char>);
+	auto hex_digit_f = [](const uint8_t v) noexcept -> char {
+		constexpr auto digits = std::string_view{ "0123456789abcdef" };
+		PRECOOKED_ASSERT(v < digits.size());
+		return digits[v];
+	};
+	const auto left_digit = hex_digit_f(value / 16);
+	const auto right_digit = hex_digit_f(value % 16);
+	return hexchars_t{ left_digit, right_digit };
+};
+}
 
+namespace peo::detail {
+// Appends to a std::string, numbers are formatted in place
+class pretty_string_appender {
+public:
+	explicit pretty_string_appender(std::string& str) noexcept : str_{ str } {}
+	auto append(const std::string_view sv) -> void { str_.append(sv); }
+	auto append(const char c) -> void { str_.push_back(c); }
+	template <typename T, typename... FormatArgs>
+	auto append_number(const T value, const FormatArgs... format_args) -> void {
+		const auto size = str_.size();
+		// Long fixed representations of floating point values retry with more space
+		for (auto max_size = size_t{ 64 };; max_size *= 8) {
+			str_.resize(size + max_size);
+			auto* first = str_.data() + size;
+			if (const auto* end = impl_number_to_chars(first, first + max_size, value, format_args...); end != nullptr) PRECOOKED_LIKELY {
+				str_.resize(size + static_cast<size_t>(end - first));
+				return;
+			}
+		}
+	}
+private:
+	std::string& str_;
+};
 
+// Writes through an output iterator
+template <typename OutputIt>
+class pretty_string_writer {
+public:
+	explicit pretty_string_writer(OutputIt it) : it_{ it } {}
+	auto append(const std::string_view sv) -> void { it_ = std::copy(sv.begin(), sv.end(), it_); }
+	auto append(const char c) -> void { *it_++ = c; }
+	template <typename T, typename... FormatArgs>
+	auto append_number(const T value, const FormatArgs... format_args) -> void {
+		auto buffer = std::array<char, 64>{};
+		if (const auto* end = impl_number_to_chars(buffer.data(), buffer.data() + buffer.size(), value, format_args...); end != nullptr) PRECOOKED_LIKELY {
+			append(std::string_view{ buffer.data(), static_cast<size_t>(end - buffer.data()) });
+			return;
+		}
+		auto str = std::string{};
+		pretty_string_appender{ str }.append_number(value, format_args...);
+		append(str);
+	}
+	[[nodiscard]] auto it() const -> OutputIt { return it_; }
+private:
+	OutputIt it_;
+};
 
+// Out is a peo::string_builder or one of the writers above, 
+// providing append(std::string_view), append(char) and append_number
+template <typename Out, typename T>
+auto impl_pretty_string_to(Out& out, const T& value) -> void {
+	using value_t = std::decay_t<T>;
+	using namespace std::string_view_literals;
+	if constexpr (std::is_same_v<std::string, value_t> || std::is_same_v<std::string_view, value_t>) {
+		out.append(std::string_view{ value });
+	}
+	else if constexpr (type_traits::is_string_v<value_t>) {
+		using src_char_t = type_traits::underlying_char_t<T>;
+		using dst_char_t = std::string::value_type;
+		const auto truncate_to_dst_char_f = [](const src_char_t& src_char) noexcept -> dst_char_t {
+			const auto dst_char = static_cast<dst_char_t>(src_char);
+			const auto is_truncated = static_cast<src_char_t>(dst_char) != src_char;
+			return is_truncated ?
+				dst_char_t{ '?' } :
+				dst_char;
+		};
+		for (const auto& src_char : value) {
+			out.append(truncate_to_dst_char_f(src_char));
+		}
+	}
+	else if constexpr (std::is_same_v<bool, value_t>) {
+		out.append(value ? "true"sv : "false"sv);
+	}
+	else if constexpr (std::is_floating_point_v<value_t>) {
+		// As std::to_string
+		out.append_number(value, std::chars_format::fixed, 6);
+	}
+	else if constexpr (std::is_arithmetic_v<value_t>) {
+		out.append_number(value);
+	}
+	else if constexpr (type_traits::is_smart_ptr_v<value_t>) {
+		if (value == nullptr) {
+			out.append("nullptr"sv);
+		}
+		else {
+			impl_pretty_string_to(out, *value);
+		}
+	}
+	else if constexpr (type_traits::is_weak_ptr_v<value_t>) {
+		auto sptr = value.lock();
+		impl_pretty_string_to(out, sptr);
+	}
+	else if constexpr (
+		std::is_pointer_v<value_t> && 
+		!type_traits::is_valid_char_v<std::remove_pointer_t<value_t>>
+	) {
+		if (value == nullptr) {
+			out.append("nullptr"sv);
+		}
+		else {
+			impl_pretty_string_to(out, *value);
+		}
+	}
+	else if constexpr (type_traits::is_variant_v<value_t>) {
+		std::visit([&out](auto&& candidate) {
+			impl_pretty_string_to(out, candidate);
+		}, value);
+	}
+	else if constexpr (type_traits::is_optional_v<value_t>) {
+		if (value.has_value()) {
+			impl_pretty_string_to(out, *value);
+		}
+		else {
+			out.append("std::nullopt"sv);
+		}
+	}
+	else if constexpr (std::is_same_v<std::any, value_t>) {
+		if (value.empty()) {
+			out.append("empty std::any"sv);
+		}
+		else {
+			out.append("std::any containing type "sv);
+			out.append(std::string_view{ held_type_name(value) });
+		}
+	}
+	else if constexpr (std::is_base_of_v<std::exception, value_t>) {
+		out.append(std::string_view{ value.what() });
+	}
+	else if constexpr (type_traits::has_ostream_v<value_t>) {
+		auto sstr = std::ostringstream{};
+		sstr << value;
+		out.append(std::string_view{ sstr.str() });
+	}
+	else if constexpr (type_traits::is_container_v<value_t>) {
+		out.append('[');
+		auto is_first = true;
+		for (auto&& element : value) {
+			if (!is_first) {
+				out.append(' ');
+			}
+			is_first = false;
+			impl_pretty_string_to(out, element);
+		}
+		out.append(']');
+	}
+	else if constexpr(type_traits::is_tuple_v<value_t>){
+		out.append('[');
+		auto is_first = true;
+		tuple_for_each(value, [&out, &is_first](auto&& elem) {
+			if (!is_first) {
+				out.append(' ');
+			}
+			is_first = false;
+			impl_pretty_string_to(out, elem);
+		});
+		out.append(']');
+	}
+	else if constexpr (std::is_enum_v<value_t>) {
+		using underlying_type = std::underlying_type_t<T>;
+		impl_pretty_string_to(out, static_cast<underlying_type>(value));
+	}
+	else if constexpr (type_traits::is_duration_v<value_t>) {
+		impl_pretty_string_to(out, value.count());
+	}
+	else {
+		// Encoded a block at a time, the stack use doesn't grow with the type
+		constexpr auto block_size = size_t{ 64 };
+		auto hex = std::array<char, block_size * 2>{};
+		const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+		out.append("unknown 0x"sv);
+		for (size_t offset = 0; offset < sizeof(value_t); offset += block_size) {
+			const auto num_bytes = std::min(block_size, sizeof(value_t) - offset);
+			const auto* end = impl_hex_encode(bytes + offset, num_bytes, hex.data());
+			out.append(std::string_view{ hex.data(), static_cast<size_t>(end - hex.data()) });
+		}
+	}
+}
+}
 
+template <typename T>
+auto peo::pretty_string(const T& value) -> std::string {
+	using value_t = std::decay_t<T>;
+	if constexpr (std::is_same_v<std::string, value_t>) {
+		return value;
+	}
+	else {
+		auto str = std::string{};
+		pretty_string_to(str, value);
+		return str;
+	}
+}
 
+template <typename T>
+auto peo::pretty_string_to(std::string& out, const T& value) -> void {
+	auto appender = detail::pretty_string_appender{ out };
+	detail::impl_pretty_string_to(appender, value);
+}
 
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+template <
+	typename OutputIt, 
+	typename T, 
+	std::enable_if_t<!std::is_convertible_v<OutputIt, std::string_view> || std::is_same_v<OutputIt, char*>, int>
+>
+auto peo::pretty_string_to(OutputIt out, const T& value) -> OutputIt {
+	auto writer = detail::pretty_string_writer<OutputIt>{ out };
+	detail::impl_pretty_string_to(writer, value);
+	return writer.it();
+}
 
 
 
@@ -878,24 +1825,389 @@ auto peo::join_strings(const Strings& strings) -> std::basic_string<Char> {
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
 
+#include <numeric>
+
 
 namespace peo::detail {
-#if 0
-template <typename Char>
-[[nodiscard]] constexpr auto default_trim_chars() noexcept -> std::basic_string_view<Char> {
-	using namespace std::string_view_literals;
-	static_assert(
-		std::is_same_v<Char, char> ||
-		std::is_same_v<Char, wchar_t> ||
-		std::is_same_v<Char, char16_t> ||
-		std::is_same_v<Char, char32_t>
-	);
-	if constexpr (std::is_same_v<Char, char>) { return "\t\r\n "sv; }
-	else if constexpr (std::is_same_v<Char, wchar_t>) { return L"\t\r\n "sv; }
-	else if constexpr (std::is_same_v<Char, char16_t>) { return u"\t\r\n "sv; }
-	else if constexpr (std::is_same_v<Char, char32_t>) { return U"\t\r\n "sv; }
-}
-#endif
+template <typename Strings, typename Char>
+[[nodiscard]] auto impl_join_strings(
+	const Strings& strings, 
+	const std::basic_string_view<Char>& delimiter
+) -> std::basic_string<Char> {
+	if (strings.empty()) PRECOOKED_UNLIKELY {
+		return {};
+	}
+	const auto target_size_of_strings = std::accumulate(
+		strings.begin(), 
+		strings.end(), 
+		size_t{ 0 }, 
+		[](const size_t sum, const auto& str) noexcept -> size_t {
+			return sum + str.size();
+		}
+	);
+	PRECOOKED_ASSERT(!strings.empty());
+	const auto num_delimiters = strings.size() - 1;
+	const auto target_size_of_delimiters = num_delimiters * delimiter.size();
+	const auto target_size = target_size_of_strings + target_size_of_delimiters;
+	// Merge strings
+	auto joined = std::basic_string<Char>{};
+	joined.reserve(target_size);
+	if (delimiter.empty()) {
+		// No delimiter
+		for (auto&& str : strings) {
+			joined.append(str);
+		}
+	}
+	else {
+		PRECOOKED_ASSERT(!strings.empty());
+		// Intersperse delimiter
+		for (
+			auto it = strings.begin(), it_end = std::prev(strings.end()); 
+			it != it_end; 
+			++it
+		) {
+			joined.append(*it);
+			joined.append(delimiter);
+		}
+		joined.append(strings.back());
+		// No delimiter at end
+	}
+	PRECOOKED_ASSERT(joined.size() == target_size);
+	return joined;
+}
+}
+
+template <typename Strings, typename Str>
+auto peo::join_strings(
+	const Strings& strings, 
+	const Str& delimiter
+) -> std::basic_string<type_traits::underlying_char_t<Str>> {
+	using Char = type_traits::underlying_char_t<Str>;
+	static_assert(type_traits::is_valid_char_v<Char>);
+	return detail::impl_join_strings(strings, std::basic_string_view<Char>{delimiter});
+}
+
+template <typename Strings, typename Char>
+auto peo::join_strings(const Strings& strings) -> std::basic_string<Char> {
+	static_assert(type_traits::is_valid_char_v<Char>);
+	return detail::impl_join_strings(strings, std::basic_string_view<Char>{});
+}
+
+namespace peo::detail {
+// The strings are joined in chunks concurrently. The sizes of the chunks are summed 
+// concurrently, an exclusive prefix sum of them gives the output offset of every 
+// chunk, and the chunks are then written concurrently into a single allocated result.
+template <typename Strings, typename Char>
+[[nodiscard]] auto impl_join_strings_parallel(
+	const Strings& strings, 
+	const std::basic_string_view<Char> delimiter,
+	const size_t num_threads
+) -> std::basic_string<Char> {
+	const auto num_strings = static_cast<size_t>(std::size(strings));
+	PRECOOKED_ASSERT(num_strings > 0);
+	const auto strings_begin = std::begin(strings);
+	const auto chunk_size = std::max(
+		(num_strings + num_threads * 4 - 1) / (num_threads * 4),
+		parallel_min_chunk_size
+	);
+	const auto num_chunks = (num_strings + chunk_size - 1) / chunk_size;
+	const auto chunk_begin_f = [&](const size_t chunk) noexcept {
+		return std::min(chunk * chunk_size, num_strings);
+	};
+	// Iterators to the first string of every chunk, so that any iterable is accepted
+	auto chunk_iterators = std::vector<std::decay_t<decltype(strings_begin)>>{ strings_begin };
+	chunk_iterators.reserve(num_chunks);
+	while (chunk_iterators.size() < num_chunks) {
+		chunk_iterators.push_back(std::next(chunk_iterators.back(), static_cast<std::ptrdiff_t>(chunk_size)));
+	}
+	// Sum sizes concurrently
+	auto chunk_sizes = std::vector<size_t>(num_chunks, 0);
+	impl_parallel_for(num_chunks, num_threads, [&](const size_t chunk) noexcept {
+		auto chunk_size_sum = size_t{ 0 };
+		auto it = chunk_iterators[chunk];
+		for (auto i = chunk_begin_f(chunk), end = chunk_begin_f(chunk + 1); i < end; ++i, ++it) {
+			chunk_size_sum += std::basic_string_view<Char>{ *it }.size();
+		}
+		chunk_sizes[chunk] = chunk_size_sum;
+	});
+	// Output offsets by prefix sum, every string but the last is followed by a delimiter
+	auto output_offsets = std::vector<size_t>(num_chunks + 1, 0);
+	for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+		const auto num_chunk_strings = chunk_begin_f(chunk + 1) - chunk_begin_f(chunk);
+		output_offsets[chunk + 1] = output_offsets[chunk] + chunk_sizes[chunk] + num_chunk_strings * delimiter.size();
+	}
+	const auto target_size = output_offsets.back() - delimiter.size();
+	auto joined = std::basic_string<Char>{};
+	joined.resize(target_size);
+	// Write chunks concurrently
+	impl_parallel_for(num_chunks, num_threads, [&](const size_t chunk) noexcept {
+		auto* dst = joined.data() + output_offsets[chunk];
+		auto it = chunk_iterators[chunk];
+		for (auto i = chunk_begin_f(chunk), end = chunk_begin_f(chunk + 1); i < end; ++i, ++it) {
+			const auto str = std::basic_string_view<Char>{ *it };
+			dst = std::copy(str.begin(), str.end(), dst);
+			if (i + 1 < num_strings) {
+				dst = std::copy(delimiter.begin(), delimiter.end(), dst);
+			}
+		}
+		PRECOOKED_ASSERT(dst == joined.data() + std::min(output_offsets[chunk + 1], target_size));
+	});
+	return joined;
+}
+}
+
+template <typename Strings, typename Str>
+auto peo::join_strings_parallel(
+	const Strings& strings, 
+	const Str& delimiter,
+	const size_t num_threads
+) -> std::basic_string<type_traits::underlying_char_t<Str>> {
+	using Char = type_traits::underlying_char_t<Str>;
+	static_assert(type_traits::is_valid_char_v<Char>);
+	const auto delimiter_sv = std::basic_string_view<Char>{ delimiter };
+	const auto num_threads_resolved = detail::resolve_num_threads(num_threads);
+	const auto is_parallel = 
+		num_threads_resolved > 1 && 
+		static_cast<size_t>(std::size(strings)) >= detail::parallel_min_size;
+	return is_parallel ?
+		detail::impl_join_strings_parallel(strings, delimiter_sv, num_threads_resolved) :
+		detail::impl_join_strings(strings, delimiter_sv);
+}
+
+
+
+#include <charconv>
+#include <limits>
+
+namespace peo::detail {
+// Number of decimal digits of value, at least one
+[[nodiscard]] constexpr auto num_decimal_digits(uint64_t value) noexcept -> size_t {
+	auto num_digits = size_t{ 1 };
+	for (; value >= 10000; value /= 10000) {
+		num_digits += 4;
+	}
+	return num_digits + (value >= 10) + (value >= 100) + (value >= 1000);
+}
+
+// Upper bound of the number of chars an element is joined as, 
+// exact for everything but floating point values
+template <typename Char, typename T>
+[[nodiscard]] auto impl_join_size_bound(const T& value) noexcept -> size_t {
+	using value_t = std::decay_t<T>;
+	if constexpr (std::is_same_v<value_t, Char>) {
+		return 1;
+	}
+	else if constexpr (std::is_convertible_v<const value_t&, std::basic_string_view<Char>>) {
+		return std::basic_string_view<Char>{ value }.size();
+	}
+	else if constexpr (std::is_same_v<value_t, bool>) {
+		return value ? 4 : 5;
+	}
+	else if constexpr (std::is_enum_v<value_t>) {
+		return impl_join_size_bound<Char>(static_cast<std::underlying_type_t<value_t>>(value));
+	}
+	else if constexpr (std::is_integral_v<value_t>) {
+		static_assert(!type_traits::is_valid_char_v<value_t>, "peo::join requires chars to match the delimiter");
+		if constexpr (std::is_signed_v<value_t>) {
+			const auto magnitude = value < 0 ? 
+				uint64_t{ 0 } - static_cast<uint64_t>(value) : 
+				static_cast<uint64_t>(value);
+			return (value < 0 ? 1 : 0) + num_decimal_digits(magnitude);
+		}
+		else {
+			return num_decimal_digits(static_cast<uint64_t>(value));
+		}
+	}
+	else {
+		// Sign, digits, decimal point and exponent of the shortest representation
+		static_assert(std::is_floating_point_v<value_t>, "peo::join requires strings, chars, bools, enums or arithmetic types");
+		return std::numeric_limits<value_t>::max_digits10 + 10;
+	}
+}
+
+// Writes an element to dst, last is the end of the space reserved for it
+template <typename Char, typename T>
+auto impl_join_write(Char* dst, Char* last, const T& value) noexcept -> Char* {
+	using value_t = std::decay_t<T>;
+	using namespace std::string_view_literals;
+	if constexpr (std::is_same_v<value_t, Char>) {
+		*dst = value;
+		return dst + 1;
+	}
+	else if constexpr (std::is_convertible_v<const value_t&, std::basic_string_view<Char>>) {
+		const auto sv = std::basic_string_view<Char>{ value };
+		return std::copy(sv.begin(), sv.end(), dst);
+	}
+	else if constexpr (std::is_same_v<value_t, bool>) {
+		const auto sv = value ? "true"sv : "false"sv;
+		return std::copy(sv.begin(), sv.end(), dst);
+	}
+	else if constexpr (std::is_enum_v<value_t>) {
+		return impl_join_write(dst, last, static_cast<std::underlying_type_t<value_t>>(value));
+	}
+	else {
+		auto* end = impl_number_to_chars(dst, last, value);
+		PRECOOKED_ASSERT(end != nullptr);
+		return end;
+	}
+}
+
+// The elements are measured first, and then written into a single allocated 
+// string which is finally shrunk to the formatted size of the floating point values
+template <typename Char, typename Range, typename Proj>
+[[nodiscard]] auto impl_join(
+	const Range& range,
+	const std::basic_string_view<Char> delimiter,
+	const Proj& proj
+) -> std::basic_string<Char> {
+	auto size_bound = size_t{ 0 };
+	auto num_elements = size_t{ 0 };
+	for (auto&& element : range) {
+		size_bound += impl_join_size_bound<Char>(proj(element));
+		++num_elements;
+	}
+	if (num_elements == 0) PRECOOKED_UNLIKELY {
+		return {};
+	}
+	size_bound += (num_elements - 1) * delimiter.size();
+	auto joined = std::basic_string<Char>{};
+	joined.resize(size_bound);
+	auto* dst = joined.data();
+	auto* const last = joined.data() + joined.size();
+	auto is_first = true;
+	for (auto&& element : range) {
+		if (!is_first) {
+			dst = std::copy(delimiter.begin(), delimiter.end(), dst);
+		}
+		is_first = false;
+		dst = impl_join_write(dst, last, proj(element));
+		PRECOOKED_ASSERT(dst <= last);
+	}
+	joined.resize(static_cast<size_t>(dst - joined.data()));
+	return joined;
+}
+}
+
+template <typename Range, typename Str>
+auto peo::join(
+	const Range& range, 
+	const Str& delimiter
+) -> std::basic_string<type_traits::underlying_char_t<Str>> {
+	using Char = type_traits::underlying_char_t<Str>;
+	static_assert(type_traits::is_valid_char_v<Char>);
+	const auto identity_f = [](const auto& element) noexcept -> const auto& { return element; };
+	return detail::impl_join(range, std::basic_string_view<Char>{ delimiter }, identity_f);
+}
+
+template <typename Range, typename Str, typename Proj>
+auto peo::join(
+	const Range& range, 
+	const Str& delimiter, 
+	const Proj& proj
+) -> std::basic_string<type_traits::underlying_char_t<Str>> {
+	using Char = type_traits::underlying_char_t<Str>;
+	static_assert(type_traits::is_valid_char_v<Char>);
+	return detail::impl_join(range, std::basic_string_view<Char>{ delimiter }, proj);
+}
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+
+namespace peo::detail {
+#if 0
+template <typename Char>
+[[nodiscard]] constexpr auto default_trim_chars() noexcept -> std::basic_string_view<Char> {
+	using namespace std::string_view_literals;
+	static_assert(
+		std::is_same_v<Char, char> ||
+		std::is_same_v<Char, wchar_t> ||
+		std::is_same_v<Char, char16_t> ||
+		std::is_same_v<Char, char32_t>
+	);
+	if constexpr (std::is_same_v<Char, char>) { return "\t\r\n "sv; }
+	else if constexpr (std::is_same_v<Char, wchar_t>) { return L"\t\r\n "sv; }
+	else if constexpr (std::is_same_v<Char, char16_t>) { return u"\t\r\n "sv; }
+	else if constexpr (std::is_same_v<Char, char32_t>) { return U"\t\r\n "sv; }
+}
+#endif
 template <typename Char>
 [[nodiscard]] constexpr auto linebreak_chars() noexcept -> std::basic_string_view<Char> {
 	using namespace std::string_view_literals;
@@ -917,7 +2229,195 @@ template <typename Char>
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
 
+#include <stdexcept>
+
+// Chars below 256 are tested with a single bit test, the 256-bit table is laid 
+// out as the two nibble lookup tables of the SSSE3 kernel. Chars above are kept 
+// in a small array, at most max_num_wide_chars of them.
+template <typename Char>
+class peo::basic_char_set {
+public:
+	static_assert(type_traits::is_valid_char_v<Char>);
+	static constexpr auto max_num_wide_chars = size_t{ 16 };
+	constexpr basic_char_set() noexcept = default;
+	constexpr explicit basic_char_set(const Char* chars)
+	: basic_char_set{ std::basic_string_view<Char>{ chars } } 
+	{}
+	constexpr explicit basic_char_set(const std::basic_string_view<Char> chars) {
+		for (const auto c : chars) {
+			insert(c);
+		}
+	}
+	// Throws std::length_error if there are more than max_num_wide_chars chars above 255
+	constexpr auto insert(const Char c) -> void {
+		const auto u = to_unsigned(c);
+		if (u < 256) {
+			table_[table_idx(u)] = static_cast<uint8_t>(table_[table_idx(u)] | table_bit(u));
+			return;
+		}
+		if (contains(c)) {
+			return;
+		}
+		if (num_wide_chars_ == max_num_wide_chars) PRECOOKED_UNLIKELY {
+			throw std::length_error{ "peo::basic_char_set holds too many chars above 255" };
+		}
+		wide_chars_[num_wide_chars_++] = c;
+	}
+	[[nodiscard]] constexpr auto contains(const Char c) const noexcept -> bool {
+		const auto u = to_unsigned(c);
+		if (u < 256) PRECOOKED_LIKELY {
+			return (table_[table_idx(u)] & table_bit(u)) != 0;
+		}
+		for (size_t i = 0; i < num_wide_chars_; ++i) {
+			if (wide_chars_[i] == c) {
+				return true;
+			}
+		}
+		return false;
+	}
+	// Byte (c & 0x0f) | ((c & 0x80) >> 3) holds bit (c >> 4) & 7 of the chars below 256
+	[[nodiscard]] constexpr auto table() const noexcept -> const std::array<uint8_t, 32>& { return table_; }
+private:
+	using unsigned_t = std::make_unsigned_t<Char>;
+	[[nodiscard]] static constexpr auto to_unsigned(const Char c) noexcept -> unsigned_t { 
+		return static_cast<unsigned_t>(c); 
+	}
+	[[nodiscard]] static constexpr auto table_idx(const unsigned_t u) noexcept -> size_t { 
+		return static_cast<size_t>((u & 0x0f) | ((u & 0x80) >> 3)); 
+	}
+	[[nodiscard]] static constexpr auto table_bit(const unsigned_t u) noexcept -> uint8_t { 
+		return static_cast<uint8_t>(1u << ((u >> 4) & 7)); 
+	}
+	std::array<uint8_t, 32> table_{};
+	std::array<Char, max_num_wide_chars> wide_chars_{};
+	size_t num_wide_chars_{ 0 };
+};
+
+namespace peo {
+template <typename Char> basic_char_set(const Char*) -> basic_char_set<Char>;
+template <typename Char> basic_char_set(std::basic_string_view<Char>) -> basic_char_set<Char>;
+}
+
 namespace peo::detail {
+#if PRECOOKED_SSSE3
+// Bit i is set if byte i of the block is in the set. Bytes below 0x80 are looked up in 
+// the low half of the table and bytes above in the high half, the shuffle zeroes the 
+// lanes of the half whose index has the high bit set.
+[[nodiscard]] inline auto impl_char_set_mask_ssse3(
+	const __m128i block,
+	const __m128i table_lo,
+	const __m128i table_hi
+) noexcept -> uint32_t {
+	const auto idx = _mm_and_si128(block, _mm_set1_epi8(static_cast<char>(0x8f)));
+	const auto rows = _mm_or_si128(
+		_mm_shuffle_epi8(table_lo, idx),
+		_mm_shuffle_epi8(table_hi, _mm_xor_si128(idx, _mm_set1_epi8(static_cast<char>(0x80))))
+	);
+	const auto bit_table = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+	const auto high_nibbles = _mm_and_si128(_mm_srli_epi16(block, 4), _mm_set1_epi8(0x0f));
+	const auto bits = _mm_shuffle_epi8(bit_table, high_nibbles);
+	const auto matches = _mm_cmpeq_epi8(_mm_and_si128(rows, bits), bits);
+	return static_cast<uint32_t>(_mm_movemask_epi8(matches));
+}
+#endif
+
+// Index of the first char at or after offset which is (IsMember) or is not 
+// (!IsMember) in the set, the size of sv if there is none
+template <bool IsMember, typename Char>
+[[nodiscard]] auto impl_find_first_in_set(
+	const std::basic_string_view<Char> sv,
+	const basic_char_set<Char>& set,
+	size_t offset
+) noexcept -> size_t {
+	PRECOOKED_ASSERT(offset <= sv.size());
+#if PRECOOKED_SSSE3
+	if constexpr (std::is_same_v<Char, char>) {
+		const auto* table = set.table().data();
+		const auto table_lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table));
+		const auto table_hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table + 16));
+		for (; offset + 16 <= sv.size(); offset += 16) {
+			const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sv.data() + offset));
+			auto mask = impl_char_set_mask_ssse3(block, table_lo, table_hi);
+			if constexpr (!IsMember) {
+				mask ^= 0xffff;
+			}
+			if (mask != 0) {
+				return offset + count_trailing_zeros(mask);
+			}
+		}
+	}
+#endif
+	for (; offset < sv.size(); ++offset) {
+		if (set.contains(sv[offset]) == IsMember) {
+			return offset;
+		}
+	}
+	return sv.size();
+}
+
+// Index of the last char before end which is (IsMember) or is not (!IsMember) 
+// in the set, npos if there is none
+template <bool IsMember, typename Char>
+[[nodiscard]] auto impl_find_last_in_set(
+	const std::basic_string_view<Char> sv,
+	const basic_char_set<Char>& set,
+	size_t end
+) noexcept -> size_t {
+	PRECOOKED_ASSERT(end <= sv.size());
+#if PRECOOKED_SSSE3
+	if constexpr (std::is_same_v<Char, char>) {
+		const auto* table = set.table().data();
+		const auto table_lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table));
+		const auto table_hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table + 16));
+		for (; end >= 16; end -= 16) {
+			const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sv.data() + end - 16));
+			auto mask = impl_char_set_mask_ssse3(block, table_lo, table_hi);
+			if constexpr (!IsMember) {
+				mask ^= 0xffff;
+			}
+			if (mask != 0) {
+				return end - 16 + index_of_highest_bit(mask);
+			}
+		}
+	}
+#endif
+	for (; end > 0; --end) {
+		if (set.contains(sv[end - 1]) == IsMember) {
+			return end - 1;
+		}
+	}
+	return std::basic_string_view<Char>::npos;
+}
+
+template <typename Char, typename PartType>
+[[nodiscard]] auto impl_split_string(
+	const std::basic_string_view<Char> str,
+	const basic_char_set<Char>& delimiters
+) -> std::vector<PartType> {
+	// func(left, right) is invoked with the range of every part
+	const auto for_each_part_f = [&str, &delimiters](auto&& func) {
+		for (
+			auto left = impl_find_first_in_set<false>(str, delimiters, 0);
+			left < str.size();
+		) {
+			const auto right = impl_find_first_in_set<true>(str, delimiters, left + 1);
+			PRECOOKED_ASSERT(left < right && right <= str.size());
+			func(left, right);
+			left = impl_find_first_in_set<false>(str, delimiters, right);
+		}
+	};
+	// Calculate num parts in order to allocate returned vector
+	auto num_parts = size_t{ 0 };
+	for_each_part_f([&num_parts](size_t, size_t) noexcept { ++num_parts; });
+	// Split string
+	auto parts = std::vector<PartType>{};
+	parts.reserve(num_parts);
+	for_each_part_f([&str, &parts](const size_t left, const size_t right) {
+		parts.emplace_back(str.substr(left, right - left));
+	});
+	PRECOOKED_ASSERT(parts.size() == num_parts);
+	return parts;
+}
 
 template <typename Char, typename PartType>
 [[nodiscard]] auto impl_split_string(
@@ -977,50 +2477,443 @@ template <typename Char, typename PartType>
 }
 }
 
-
-template <typename Str0, typename Str1>
-auto peo::split_string(
-	const Str0& str, 
-	const Str1& delimiters
-) -> std::vector<std::basic_string<type_traits::underlying_char_t<Str0>>> {
-	using Char = type_traits::underlying_char_t<Str0>;
-	using PartType = std::basic_string<Char>;
-	return detail::impl_split_string<Char, PartType>(str, delimiters);
+
+template <typename Str0, typename Str1>
+auto peo::split_string(
+	const Str0& str, 
+	const Str1& delimiters
+) -> std::vector<std::basic_string<type_traits::underlying_char_t<Str0>>> {
+	using Char = type_traits::underlying_char_t<Str0>;
+	using PartType = std::basic_string<Char>;
+	return detail::impl_split_string<Char, PartType>(str, delimiters);
+}
+
+template <typename Str0, typename Str1>
+auto peo::split_string_to_views(
+	const Str0& str, 
+	const Str1& delimiters
+) -> std::vector<std::basic_string_view<type_traits::underlying_char_t<Str0>>> {
+	using Char = type_traits::underlying_char_t<Str0>;
+	static_assert(type_traits::is_valid_char_v<Char>);
+	using PartType = std::basic_string_view<Char>;
+	return detail::impl_split_string<Char, PartType>(str, delimiters);
+}
+
+template <typename Str0, typename Char>
+auto peo::split_string(
+	const Str0& str, 
+	const basic_char_set<Char>& delimiters
+) -> std::vector<std::basic_string<Char>> {
+	static_assert(std::is_same_v<Char, type_traits::underlying_char_t<Str0>>);
+	using PartType = std::basic_string<Char>;
+	return detail::impl_split_string<Char, PartType>(str, delimiters);
+}
+
+template <typename Str0, typename Char>
+auto peo::split_string_to_views(
+	const Str0& str, 
+	const basic_char_set<Char>& delimiters
+) -> std::vector<std::basic_string_view<Char>> {
+	static_assert(std::is_same_v<Char, type_traits::underlying_char_t<Str0>>);
+	using PartType = std::basic_string_view<Char>;
+	return detail::impl_split_string<Char, PartType>(str, delimiters);
+}
+
+template <typename Str>
+auto peo::split_string_to_lines(
+	const Str& str
+) -> std::vector<std::basic_string<type_traits::underlying_char_t<Str>>> {
+	using Char = type_traits::underlying_char_t<Str>;
+	static_assert(type_traits::is_valid_char_v<Char>);
+	constexpr auto linebreaks = basic_char_set<Char>{ detail::linebreak_chars<Char>() };
+	return split_string(str, linebreaks);
+}
+
+
+
+
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+#include <charconv>
+#include <limits>
+
+namespace peo::detail {
+
+// Clinger's fast path, a mantissa and a power of ten which are both exactly representable 
+// are combined by a single correctly rounded operation. Returns nullptr if the number 
+// at first is not on the fast path, ie out of range, too many digits, inf or nan.
+template <typename T>
+[[nodiscard]] auto impl_parse_float_fast(
+	const char* first, 
+	const char* last, 
+	T& value
+) noexcept -> const char* {
+	static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>);
+	constexpr auto max_exact_mantissa = uint64_t{ 1 } << std::numeric_limits<T>::digits;
+	constexpr auto max_exact_exponent = std::is_same_v<T, float> ? 10 : 22;
+	constexpr auto powers_of_ten = std::array<T, 23>{ 
+		T(1e0), T(1e1), T(1e2), T(1e3), T(1e4), T(1e5), T(1e6), T(1e7), T(1e8), T(1e9), T(1e10), T(1e11),
+		T(1e12), T(1e13), T(1e14), T(1e15), T(1e16), T(1e17), T(1e18), T(1e19), T(1e20), T(1e21), T(1e22)
+	};
+	const auto is_negative = first != last && *first == '-';
+	first += is_negative ? 1 : 0;
+	auto mantissa = uint64_t{ 0 };
+	auto num_digits = size_t{ 0 };
+	auto exponent = int64_t{ 0 };
+	const auto* integer_begin = first;
+	for (; first != last && *first == '0'; ++first) {}
+	first = impl_accumulate_digits(first, last, mantissa, num_digits, 19);
+	auto has_digits = first != integer_begin;
+	if (first != last && *first == '.') {
+		++first;
+		const auto* fraction_begin = first;
+		if (mantissa == 0) {
+			for (; first != last && *first == '0'; ++first) {}
+		}
+		first = impl_accumulate_digits(first, last, mantissa, num_digits, 19);
+		exponent -= first - fraction_begin;
+		has_digits = has_digits || first != fraction_begin;
+	}
+	const auto is_truncated = first != last && is_digit(*first);
+	if (!has_digits || is_truncated) {
+		return nullptr;
+	}
+	if (first != last && (*first == 'e' || *first == 'E')) {
+		++first;
+		const auto is_negative_exponent = first != last && *first == '-';
+		first += first != last && (*first == '-' || *first == '+') ? 1 : 0;
+		if (first == last || !is_digit(*first)) {
+			return nullptr;
+		}
+		auto exponent_digits = int64_t{ 0 };
+		for (; first != last && is_digit(*first); ++first) {
+			exponent_digits = std::min(exponent_digits * 10 + (*first - '0'), int64_t{ 100000 });
+		}
+		exponent += is_negative_exponent ? -exponent_digits : exponent_digits;
+	}
+	if (mantissa > max_exact_mantissa) {
+		return nullptr;
+	}
+	if (mantissa == 0) {
+		value = is_negative ? -T(0) : T(0);
+		return first;
+	}
+	if (exponent < -max_exact_exponent || exponent > max_exact_exponent) {
+		return nullptr;
+	}
+	auto result = static_cast<T>(mantissa);
+	result = exponent < 0 ?
+		result / powers_of_ten[static_cast<size_t>(-exponent)] :
+		result * powers_of_ten[static_cast<size_t>(exponent)];
+	value = is_negative ? -result : result;
+	return first;
+}
+
+// Parses the number at first as std::from_chars does, returns nullptr if it is invalid
+template <typename T>
+[[nodiscard]] auto impl_parse_number(
+	const char* first, 
+	const char* last, 
+	T& value
+) noexcept -> const char* {
+	static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "T needs to be an arithmetic type");
+	if constexpr (std::is_integral_v<T>) {
+		return impl_parse_integer(first, last, value);
+	}
+	else {
+		if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+			if (const auto* end = impl_parse_float_fast(first, last, value); end != nullptr) PRECOOKED_LIKELY {
+				return end;
+			}
+		}
+		const auto parsed = std::from_chars(first, last, value);
+		return parsed.ec == std::errc{} ? parsed.ptr : nullptr;
+	}
+}
+
+// Delimiters which may be part of a number require the token end to be found 
+// before parsing, otherwise the parser finds it
+[[nodiscard]] inline auto is_number_delimited_by_parser(const char_set& delimiters) noexcept -> bool {
+	for (size_t i = 0; i < 128; ++i) {
+		const auto c = static_cast<char>(i);
+		const auto is_number_char = 
+			(c >= '0' && c <= '9') || 
+			(c >= 'a' && c <= 'z') || 
+			(c >= 'A' && c <= 'Z') || 
+			std::string_view{ "+-._()" }.find(c) != std::string_view::npos;
+		if (is_number_char && delimiters.contains(c)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Invokes emit_f(value) for every token, emit_f returns false to stop
+template <typename T, typename Emit>
+[[nodiscard]] auto impl_parse_numbers(
+	const std::string_view text,
+	const char_set& delimiters,
+	const Emit& emit_f
+) -> parse_numbers_into_result {
+	auto result = parse_numbers_into_result{};
+	const auto is_delimited_by_parser = is_number_delimited_by_parser(delimiters);
+	for (
+		auto offset = impl_find_first_in_set<false>(text, delimiters, 0);
+		offset < text.size();
+		offset = impl_find_first_in_set<false>(text, delimiters, offset)
+	) {
+		const auto* token_end = is_delimited_by_parser ?
+			text.data() + text.size() :
+			text.data() + impl_find_first_in_set<true>(text, delimiters, offset);
+		auto value = T{};
+		const auto* end = impl_parse_number(text.data() + offset, token_end, value);
+		const auto is_valid = 
+			end != nullptr && 
+			(end == token_end || delimiters.contains(*end));
+		if (!is_valid) {
+			result.offset = offset;
+			result.is_invalid = true;
+			return result;
+		}
+		if (!emit_f(value)) {
+			result.offset = offset;
+			return result;
+		}
+		++result.num_parsed;
+		offset = static_cast<size_t>(end - text.data());
+	}
+	result.offset = text.size();
+	return result;
+}
+}
+
+template <typename T>
+auto peo::parse_numbers(
+	const std::string_view text, 
+	const char_set& delimiters
+) -> parse_numbers_result<T> {
+	auto result = parse_numbers_result<T>{};
+	const auto parsed = detail::impl_parse_numbers<T>(text, delimiters, [&result](const T& value) {
+		result.numbers.push_back(value);
+		return true;
+	});
+	if (parsed.is_invalid) {
+		result.invalid_offset = parsed.offset;
+	}
+	return result;
+}
+
+template <typename T>
+auto peo::parse_numbers(
+	const std::string_view text, 
+	const std::string_view delimiters
+) -> parse_numbers_result<T> {
+	return parse_numbers<T>(text, char_set{ delimiters });
+}
+
+template <typename T>
+auto peo::parse_numbers_into(
+	const std::string_view text, 
+	const char_set& delimiters, 
+	T* dst, 
+	const size_t dst_size
+) noexcept -> parse_numbers_into_result {
+	auto num_written = size_t{ 0 };
+	return detail::impl_parse_numbers<T>(text, delimiters, [&](const T& value) noexcept {
+		if (num_written == dst_size) {
+			return false;
+		}
+		dst[num_written++] = value;
+		return true;
+	});
+}
+
+template <typename T>
+auto peo::parse_numbers_into(
+	const std::string_view text, 
+	const std::string_view delimiters, 
+	T* dst, 
+	const size_t dst_size
+) noexcept -> parse_numbers_into_result {
+	return parse_numbers_into<T>(text, char_set{ delimiters }, dst, dst_size);
+}
+
+
+
+
+
+
+
+
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+#include <locale>
+#include <array>
+
+namespace peo::detail {
+
+// The classic locale folds the case of ASCII letters only, which 
+// allows folding without calls through the ctype facet
+template <typename Char>
+[[nodiscard]] auto is_classic_ctype(const std::locale& loc) noexcept -> bool {
+	if constexpr (std::is_same_v<Char, char>) {
+		static const auto* classic_ctype = &std::use_facet<std::ctype<char>>(std::locale::classic());
+		return &std::use_facet<std::ctype<char>>(loc) == classic_ctype;
+	}
+	else {
+		return false;
+	}
+}
+
+[[nodiscard]] constexpr auto ascii_to_lower(const char c) noexcept -> char {
+	const auto is_upper = static_cast<unsigned char>(c - 'A') < 26;
+	return static_cast<char>(c | (is_upper << 5));
 }
 
-template <typename Str0, typename Str1>
-auto peo::split_string_to_views(
-	const Str0& str, 
-	const Str1& delimiters
-) -> std::vector<std::basic_string_view<type_traits::underlying_char_t<Str0>>> {
-	using Char = type_traits::underlying_char_t<Str0>;
-	static_assert(type_traits::is_valid_char_v<Char>);
-	using PartType = std::basic_string_view<Char>;
-	return detail::impl_split_string<Char, PartType>(str, delimiters);
+[[nodiscard]] constexpr auto ascii_to_upper(const char c) noexcept -> char {
+	const auto is_lower = static_cast<unsigned char>(c - 'a') < 26;
+	return static_cast<char>(c & ~(is_lower << 5));
 }
 
-template <typename Str>
-auto peo::split_string_to_lines(
-	const Str& str
-) -> std::vector<std::basic_string<type_traits::underlying_char_t<Str>>> {
-	using Char = type_traits::underlying_char_t<Str>;
-	static_assert(type_traits::is_valid_char_v<Char>);
-	return split_string(str, detail::linebreak_chars<Char>());
+#if PRECOOKED_SSE2
+[[nodiscard]] inline auto ascii_to_lower_sse2(const __m128i v) noexcept -> __m128i {
+	// Signed compare of the offset chars finds the range 'A'-'Z'
+	const auto offset = _mm_add_epi8(v, _mm_set1_epi8(static_cast<char>(128 - 'A')));
+	const auto is_upper = _mm_cmplt_epi8(offset, _mm_set1_epi8(static_cast<char>(-128 + 26)));
+	return _mm_or_si128(v, _mm_and_si128(is_upper, _mm_set1_epi8(0x20)));
 }
 
+[[nodiscard]] inline auto ascii_to_upper_sse2(const __m128i v) noexcept -> __m128i {
+	const auto offset = _mm_add_epi8(v, _mm_set1_epi8(static_cast<char>(128 - 'a')));
+	const auto is_lower = _mm_cmplt_epi8(offset, _mm_set1_epi8(static_cast<char>(-128 + 26)));
+	return _mm_andnot_si128(_mm_and_si128(is_lower, _mm_set1_epi8(0x20)), v);
+}
+#endif
 
+#if PRECOOKED_AVX2
+[[nodiscard]] inline auto ascii_to_lower_avx2(const __m256i v) noexcept -> __m256i {
+	const auto offset = _mm256_add_epi8(v, _mm256_set1_epi8(static_cast<char>(128 - 'A')));
+	const auto is_upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(-128 + 26)), offset);
+	return _mm256_or_si256(v, _mm256_and_si256(is_upper, _mm256_set1_epi8(0x20)));
+}
 
+[[nodiscard]] inline auto ascii_to_upper_avx2(const __m256i v) noexcept -> __m256i {
+	const auto offset = _mm256_add_epi8(v, _mm256_set1_epi8(static_cast<char>(128 - 'a')));
+	const auto is_lower = _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(-128 + 26)), offset);
+	return _mm256_andnot_si256(_mm256_and_si256(is_lower, _mm256_set1_epi8(0x20)), v);
+}
+#endif
 
+// Folds case through the facets of a locale, on the fly. 
+// Shares interface with peo::case_folder.
+class locale_folder {
+public:
+	explicit locale_folder(const std::locale& loc) noexcept
+	: loc_{ loc }
+	, is_classic_{ is_classic_ctype<char>(loc) } 
+	{}
+	template <typename Char>
+	[[nodiscard]] auto to_lower(const Char c) const -> Char {
+		if constexpr (std::is_same_v<Char, char>) {
+			if (is_classic_) PRECOOKED_LIKELY {
+				return ascii_to_lower(c);
+			}
+		}
+		return std::tolower(c, loc_);
+	}
+	template <typename Char>
+	[[nodiscard]] auto to_upper(const Char c) const -> Char {
+		if constexpr (std::is_same_v<Char, char>) {
+			if (is_classic_) PRECOOKED_LIKELY {
+				return ascii_to_upper(c);
+			}
+		}
+		return std::toupper(c, loc_);
+	}
+	template <typename Char>
+	[[nodiscard]] auto is_space(const Char c) const -> bool {
+		return std::isspace(c, loc_);
+	}
+	// The char case folding of the locale is the ASCII only classic one
+	[[nodiscard]] auto is_classic() const noexcept -> bool { return is_classic_; }
+	// ASCII chars are folded like the classic locale
+	[[nodiscard]] auto is_ascii_compatible() const noexcept -> bool { return is_classic_; }
+private:
+	const std::locale& loc_;
+	bool is_classic_{ false };
+};
+}
 
 
+// Folds case with the ctype facets of a locale, the char facet is tabulated 
+// at construction and the wchar_t facet is cached. Build it once and pass it 
+// instead of a std::locale to the case insensitive functions.
+class peo::case_folder {
+public:
+	explicit case_folder(const std::locale& loc = std::locale{})
+	: loc_{ loc }
+	, wide_ctype_{ &std::use_facet<std::ctype<wchar_t>>(loc_) }
+	, is_classic_{ detail::is_classic_ctype<char>(loc_) } {
+		const auto& ctype = std::use_facet<std::ctype<char>>(loc_);
+		for (size_t i = 0; i < lower_table_.size(); ++i) {
+			const auto c = static_cast<char>(i);
+			lower_table_[i] = ctype.tolower(c);
+			upper_table_[i] = ctype.toupper(c);
+			space_table_[i] = ctype.is(std::ctype_base::space, c);
+		}
+		is_ascii_compatible_ = true;
+		for (size_t i = 0; i < 128; ++i) {
+			const auto c = static_cast<char>(i);
+			is_ascii_compatible_ = is_ascii_compatible_ && 
+				lower_table_[i] == detail::ascii_to_lower(c) &&
+				upper_table_[i] == detail::ascii_to_upper(c);
+		}
+	}
+	template <typename Char>
+	[[nodiscard]] auto to_lower(const Char c) const -> Char {
+		if constexpr (std::is_same_v<Char, char>) { return lower_table_[to_idx(c)]; }
+		else if constexpr (std::is_same_v<Char, wchar_t>) { return wide_ctype_->tolower(c); }
+		else { return std::tolower(c, loc_); }
+	}
+	template <typename Char>
+	[[nodiscard]] auto to_upper(const Char c) const -> Char {
+		if constexpr (std::is_same_v<Char, char>) { return upper_table_[to_idx(c)]; }
+		else if constexpr (std::is_same_v<Char, wchar_t>) { return wide_ctype_->toupper(c); }
+		else { return std::toupper(c, loc_); }
+	}
+	template <typename Char>
+	[[nodiscard]] auto is_space(const Char c) const -> bool {
+		if constexpr (std::is_same_v<Char, char>) { return space_table_[to_idx(c)]; }
+		else if constexpr (std::is_same_v<Char, wchar_t>) { return wide_ctype_->is(std::ctype_base::space, c); }
+		else { return std::isspace(c, loc_); }
+	}
+	// The char case folding of the locale is the ASCII only classic one
+	[[nodiscard]] auto is_classic() const noexcept -> bool { return is_classic_; }
+	// ASCII chars are folded like the classic locale, other chars may not be
+	[[nodiscard]] auto is_ascii_compatible() const noexcept -> bool { return is_ascii_compatible_; }
+	[[nodiscard]] auto locale() const noexcept -> const std::locale& { return loc_; }
+private:
+	[[nodiscard]] static constexpr auto to_idx(const char c) noexcept -> size_t { 
+		return static_cast<unsigned char>(c); 
+	}
+	std::locale loc_{};
+	const std::ctype<wchar_t>* wide_ctype_{ nullptr };
+	bool is_classic_{ false };
+	bool is_ascii_compatible_{ false };
+	std::array<char, 256> lower_table_{};
+	std::array<char, 256> upper_table_{};
+	std::array<bool, 256> space_table_{};
+};
 
 
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
 
-#include <locale>
-
 
 namespace peo::detail {
 template <typename Char, typename IsTrimChar>
@@ -1085,6 +2978,21 @@ template <typename Char, typename IsTrimChar>
 	return { offset, count};
 };
 
+template <typename Char>
+[[nodiscard]] auto impl_find_trimmed_range(
+	const std::basic_string_view<Char>& sv,
+	const basic_char_set<Char>& trim_chars
+) noexcept -> idxrange_t {
+	const auto first_valid_idx = impl_find_first_in_set<false>(sv, trim_chars, 0);
+	if (first_valid_idx == sv.size()) {
+		return {};
+	}
+	const auto last_valid_idx = impl_find_last_in_set<false>(sv, trim_chars, sv.size());
+	PRECOOKED_ASSERT(first_valid_idx <= last_valid_idx);
+	PRECOOKED_ASSERT(last_valid_idx < sv.size());
+	return { first_valid_idx, last_valid_idx + 1 - first_valid_idx };
+}
+
 }
 
 
@@ -1187,6 +3095,59 @@ auto peo::is_trimmed(
 	);
 }
 
+template<typename Str0>
+auto peo::is_trimmed(
+	const Str0& str,
+	const case_folder& folder
+) noexcept -> bool {
+	using Char = type_traits::underlying_char_t<Str0>;
+	static_assert(type_traits::is_valid_char_v<Char>);
+	const auto sv = std::basic_string_view<Char>{ str };
+	const auto is_trim_char_f = [&folder](const Char& c) noexcept {
+		return folder.is_space(c);
+	};
+	return detail::impl_is_trimmed(
+		sv,
+		is_trim_char_f
+	);
+}
+
+template <typename Char>
+auto peo::trim_string(
+	std::basic_string<Char> str,
+	const case_folder& folder
+) noexcept -> std::basic_string<Char> {
+	const auto is_trim_char_f = [&folder](const Char& c) noexcept {
+		return folder.is_space(c);
+	};
+	const auto range = detail::impl_find_trimmed_range(
+		std::basic_string_view<Char>{str},
+		is_trim_char_f
+	);
+	PRECOOKED_ASSERT(range.end_idx() <= str.size());
+	str.resize(range.end_idx());
+	str.erase(str.begin(), str.begin() + range.offset());
+	return str;
+}
+
+template <typename Str0>
+auto peo::trim_string_to_view(
+	const Str0& str,
+	const case_folder& folder
+) noexcept -> std::basic_string_view<type_traits::underlying_char_t<Str0>> {
+	using Char = type_traits::underlying_char_t<Str0>;
+	static_assert(type_traits::is_valid_char_v<Char>);
+	const auto is_trim_char_f = [&folder](const Char& c) noexcept {
+		return folder.is_space(c);
+	};
+	const auto sv = std::basic_string_view<Char>{ str };
+	const auto range = detail::impl_find_trimmed_range(
+		sv,
+		is_trim_char_f
+	);
+	return sv.substr(range.offset(), range.count());
+}
+
 template<typename Str0, typename Str1>
 auto peo::is_trimmed(
 	const Str0& str, 
@@ -1205,6 +3166,262 @@ auto peo::is_trimmed(
 	);
 }
 
+template<typename Str0, typename Char>
+auto peo::is_trimmed(
+	const Str0& str, 
+	const basic_char_set<Char>& trim_chars
+) noexcept -> bool {
+	static_assert(std::is_same_v<Char, type_traits::underlying_char_t<Str0>>);
+	const auto sv = std::basic_string_view<Char>{ str };
+	const auto is_trim_char_f = [&trim_chars](const Char& candidate) noexcept -> bool {
+		return trim_chars.contains(candidate);
+	};
+	return detail::impl_is_trimmed(
+		sv,
+		is_trim_char_f
+	);
+}
+
+template <typename Char>
+auto peo::trim_string(
+	std::basic_string<Char> str,
+	const basic_char_set<Char>& trim_chars
+) noexcept -> std::basic_string<Char> {
+	const auto range = detail::impl_find_trimmed_range(
+		std::basic_string_view<Char>{str},
+		trim_chars
+	);
+	PRECOOKED_ASSERT(range.end_idx() <= str.size());
+	str.resize(range.end_idx());
+	str.erase(str.begin(), str.begin() + range.offset());
+	return str;
+}
+
+template <typename Str0, typename Char>
+auto peo::trim_string_to_view(
+	const Str0& str,
+	const basic_char_set<Char>& trim_chars
+) noexcept -> std::basic_string_view<Char> {
+	static_assert(std::is_same_v<Char, type_traits::underlying_char_t<Str0>>);
+	const auto sv = std::basic_string_view<Char>{ str };
+	const auto range = detail::impl_find_trimmed_range(
+		sv,
+		trim_chars
+	);
+	return sv.substr(range.offset(), range.count());
+}
+
+
+
+#include <algorithm>
+
+namespace peo::detail {
+
+// The whitespace of the classic locale, ' ' and '\t' '\n' '\v' '\f' '\r' (0x09 to 0x0d)
+[[nodiscard]] constexpr auto is_classic_space(const char c) noexcept -> bool {
+	return c == ' ' || static_cast<unsigned char>(c - '\t') <= 4;
+}
+
+#if PRECOOKED_SSE2
+// Bit i is set if byte i of the block is whitespace of the classic locale
+[[nodiscard]] inline auto impl_classic_space_mask_sse2(const __m128i block) noexcept -> uint32_t {
+	const auto is_blank = _mm_cmpeq_epi8(block, _mm_set1_epi8(' '));
+	const auto control_offset = _mm_sub_epi8(block, _mm_set1_epi8('\t'));
+	const auto is_control = _mm_cmpeq_epi8(
+		_mm_min_epu8(control_offset, _mm_set1_epi8(4)), 
+		control_offset
+	);
+	return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(is_blank, is_control)));
+}
+#endif
+
+// Index of the first char which is not classic whitespace, the size of sv if there is none
+[[nodiscard]] inline auto impl_skip_classic_spaces(const std::string_view sv) noexcept -> size_t {
+	auto i = size_t{ 0 };
+#if PRECOOKED_SSE2
+	for (; i + 16 <= sv.size(); i += 16) {
+		const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sv.data() + i));
+		const auto mask = impl_classic_space_mask_sse2(block) ^ 0xffff;
+		if (mask != 0) {
+			return i + count_trailing_zeros(mask);
+		}
+	}
+#endif
+	for (; i < sv.size() && is_classic_space(sv[i]); ++i) {}
+	return i;
+}
+
+// One past the index of the last char which is not classic whitespace, zero if there is none
+[[nodiscard]] inline auto impl_skip_classic_spaces_backward(const std::string_view sv) noexcept -> size_t {
+	auto end = sv.size();
+#if PRECOOKED_SSE2
+	for (; end >= 16; end -= 16) {
+		const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sv.data() + end - 16));
+		const auto mask = impl_classic_space_mask_sse2(block) ^ 0xffff;
+		if (mask != 0) {
+			return end - 16 + index_of_highest_bit(mask) + 1;
+		}
+	}
+#endif
+	for (; end > 0 && is_classic_space(sv[end - 1]); --end) {}
+	return end;
+}
+
+[[nodiscard]] inline auto impl_find_classic_trimmed_range(const std::string_view sv) noexcept -> idxrange_t {
+	const auto first_valid_idx = impl_skip_classic_spaces(sv);
+	if (first_valid_idx == sv.size()) {
+		return {};
+	}
+	const auto end_idx = impl_skip_classic_spaces_backward(sv);
+	PRECOOKED_ASSERT(first_valid_idx < end_idx);
+	return { first_valid_idx, end_idx - first_valid_idx };
+}
+
+// Trims a std::basic_string in place or narrows a std::basic_string_view
+template <typename Str, typename FindRange>
+auto impl_trim_in_place(Str& str, const FindRange& find_range_f) noexcept -> void {
+	using Char = typename Str::value_type;
+	const auto range = find_range_f(std::basic_string_view<Char>{ str });
+	PRECOOKED_ASSERT(range.end_idx() <= str.size());
+	if constexpr (std::is_same_v<Str, std::basic_string_view<Char>>) {
+		str = str.substr(range.offset(), range.count());
+	}
+	else {
+		static_assert(std::is_same_v<Str, std::basic_string<Char>>);
+		str.resize(range.end_idx());
+		str.erase(0, range.offset());
+	}
+}
+
+// Invokes func(find_range_f) with the fastest range finder for the whitespace of the 
+// locale, the classic locale is trimmed by a SIMD kernel and the spaces of other 
+// locales are tabulated once for all strings
+template <typename Char, typename Func>
+auto impl_with_trimmed_range_finder(const std::locale& loc, const Func& func) -> void {
+	if constexpr (std::is_same_v<Char, char>) {
+		if (is_classic_ctype<char>(loc)) {
+			func([](const std::string_view sv) noexcept {
+				return impl_find_classic_trimmed_range(sv);
+			});
+			return;
+		}
+		const auto& ctype = std::use_facet<std::ctype<char>>(loc);
+		auto spaces = basic_char_set<char>{};
+		for (size_t i = 0; i < 256; ++i) {
+			const auto c = static_cast<char>(i);
+			if (ctype.is(std::ctype_base::space, c)) {
+				spaces.insert(c);
+			}
+		}
+		func([&spaces](const std::string_view sv) noexcept {
+			return impl_find_trimmed_range(sv, spaces);
+		});
+	}
+	else {
+		const auto& ctype = std::use_facet<std::ctype<Char>>(loc);
+		const auto is_trim_char_f = [&ctype](const Char& c) noexcept {
+			return ctype.is(std::ctype_base::space, c);
+		};
+		func([&is_trim_char_f](const std::basic_string_view<Char> sv) noexcept {
+			return impl_find_trimmed_range(sv, is_trim_char_f);
+		});
+	}
+}
+
+template <typename Str, typename FindRange>
+auto impl_trim_all(
+	Str* strs, 
+	const size_t num_strs, 
+	const FindRange& find_range_f
+) noexcept -> void {
+	for (size_t i = 0; i < num_strs; ++i) {
+		impl_trim_in_place(strs[i], find_range_f);
+	}
+}
+
+// The strings are trimmed in chunks concurrently
+template <typename Str, typename FindRange>
+auto impl_trim_all_parallel(
+	Str* strs, 
+	const size_t num_strs, 
+	const FindRange& find_range_f, 
+	const size_t num_threads
+) -> void {
+	const auto num_threads_resolved = resolve_num_threads(num_threads);
+	const auto is_parallel = 
+		num_threads_resolved > 1 &&
+		num_strs >= parallel_min_size;
+	if (!is_parallel) {
+		impl_trim_all(strs, num_strs, find_range_f);
+		return;
+	}
+	const auto chunk_size = std::max(
+		(num_strs + num_threads_resolved * 4 - 1) / (num_threads_resolved * 4),
+		parallel_min_chunk_size
+	);
+	const auto num_chunks = (num_strs + chunk_size - 1) / chunk_size;
+	impl_parallel_for(num_chunks, num_threads_resolved, [&](const size_t chunk) noexcept {
+		const auto chunk_begin = chunk * chunk_size;
+		const auto chunk_end = std::min(chunk_begin + chunk_size, num_strs);
+		impl_trim_all(strs + chunk_begin, chunk_end - chunk_begin, find_range_f);
+	});
+}
+}
+
+template <typename Container>
+auto peo::trim_all(
+	Container& strs,
+	const std::locale& loc
+) -> void {
+	using Str = std::remove_reference_t<decltype(*std::data(strs))>;
+	using Char = typename Str::value_type;
+	static_assert(type_traits::is_valid_char_v<Char>);
+	detail::impl_with_trimmed_range_finder<Char>(loc, [&strs](const auto& find_range_f) {
+		detail::impl_trim_all(std::data(strs), std::size(strs), find_range_f);
+	});
+}
+
+template <typename Container, typename Char>
+auto peo::trim_all(
+	Container& strs,
+	const basic_char_set<Char>& trim_chars
+) noexcept -> void {
+	using Str = std::remove_reference_t<decltype(*std::data(strs))>;
+	static_assert(std::is_same_v<Char, typename Str::value_type>);
+	const auto find_range_f = [&trim_chars](const std::basic_string_view<Char> sv) noexcept {
+		return detail::impl_find_trimmed_range(sv, trim_chars);
+	};
+	detail::impl_trim_all(std::data(strs), std::size(strs), find_range_f);
+}
+
+template <typename Container>
+auto peo::trim_all_parallel(
+	Container& strs,
+	const std::locale& loc,
+	const size_t num_threads
+) -> void {
+	using Str = std::remove_reference_t<decltype(*std::data(strs))>;
+	using Char = typename Str::value_type;
+	static_assert(type_traits::is_valid_char_v<Char>);
+	detail::impl_with_trimmed_range_finder<Char>(loc, [&strs, num_threads](const auto& find_range_f) {
+		detail::impl_trim_all_parallel(std::data(strs), std::size(strs), find_range_f, num_threads);
+	});
+}
+
+template <typename Container, typename Char>
+auto peo::trim_all_parallel(
+	Container& strs,
+	const basic_char_set<Char>& trim_chars,
+	const size_t num_threads
+) -> void {
+	using Str = std::remove_reference_t<decltype(*std::data(strs))>;
+	static_assert(std::is_same_v<Char, typename Str::value_type>);
+	const auto find_range_f = [&trim_chars](const std::basic_string_view<Char> sv) noexcept {
+		return detail::impl_find_trimmed_range(sv, trim_chars);
+	};
+	detail::impl_trim_all_parallel(std::data(strs), std::size(strs), find_range_f, num_threads);
+}
+
 
 
 
@@ -1218,6 +3435,66 @@ auto peo::is_trimmed(
 
 namespace peo::detail {
 
+[[nodiscard]] inline auto impl_is_equal_ascii_ignore_case(
+	const char* a,
+	const char* b,
+	const size_t size
+) noexcept -> bool {
+	auto i = size_t{ 0 };
+#if PRECOOKED_SSE2
+	for (; i + 16 <= size; i += 16) {
+		const auto va = ascii_to_lower_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+		const auto vb = ascii_to_lower_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) != 0xffff) {
+			return false;
+		}
+	}
+#endif
+	for (; i < size; ++i) {
+		if (ascii_to_lower(a[i]) != ascii_to_lower(b[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+[[nodiscard]] inline auto impl_find_ascii_ignore_case(
+	const std::string_view& haystack,
+	const std::string_view& needle,
+	const size_t offset
+) noexcept -> size_t {
+	PRECOOKED_ASSERT(haystack.size() >= needle.size());
+	PRECOOKED_ASSERT(!needle.empty());
+	const auto i_end = (1 + haystack.size()) - needle.size();
+	const auto is_window_match_f = [&haystack, &needle](const size_t i) noexcept {
+		return impl_is_equal_ascii_ignore_case(haystack.data() + i, needle.data(), needle.size());
+	};
+	auto i = offset;
+#if PRECOOKED_SSE2
+	// Candidates are positions where both the first and the last char of the needle match
+	const auto front = _mm_set1_epi8(ascii_to_lower(needle.front()));
+	const auto back = _mm_set1_epi8(ascii_to_lower(needle.back()));
+	for (; i < i_end && i_end - i >= 16; i += 16) {
+		const auto* ptr = haystack.data() + i;
+		const auto first_chars = ascii_to_lower_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)));
+		const auto last_chars = ascii_to_lower_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + needle.size() - 1)));
+		const auto candidates = _mm_and_si128(_mm_cmpeq_epi8(first_chars, front), _mm_cmpeq_epi8(last_chars, back));
+		for (auto bits = static_cast<uint32_t>(_mm_movemask_epi8(candidates)); bits != 0; bits &= bits - 1) {
+			const auto candidate = i + count_trailing_zeros(bits);
+			if (is_window_match_f(candidate)) {
+				return candidate;
+			}
+		}
+	}
+#endif
+	for (; i < i_end; ++i) {
+		if (is_window_match_f(i)) {
+			return i;
+		}
+	}
+	return std::string_view::npos;
+}
+
 
 constexpr auto find_case_sensitive_f = [](
 	const auto& haystack, 
@@ -1229,18 +3506,19 @@ constexpr auto find_case_sensitive_f = [](
 
 
 
-template <typename Char>
-[[nodiscard]] auto impl_is_equal_ignore_case(
+// Folder is either a detail::locale_folder or a peo::case_folder
+template <typename Char, typename Folder>
+[[nodiscard]] auto impl_is_equal_ignore_case_folded(
 	const std::basic_string_view<Char>& a,
 	const std::basic_string_view<Char>& b,
-	const std::locale& loc
+	const Folder& folder
 ) noexcept -> bool {
 	PRECOOKED_ASSERT(a.size() == b.size());
-	const auto is_chars_equal_ignore_case_f = [&loc](
+	const auto is_chars_equal_ignore_case_f = [&folder](
 		const auto& a,
 		const auto& b
 	) noexcept {
-		return a == b || std::tolower(a, loc) == std::tolower(b, loc);
+		return a == b || folder.to_lower(a) == folder.to_lower(b);
 	};
 	return std::equal(
 		a.begin(), 
@@ -1250,25 +3528,41 @@ template <typename Char>
 	);
 }
 
+template <typename Char, typename Folder>
+[[nodiscard]] auto impl_is_equal_ignore_case(
+	const std::basic_string_view<Char>& a,
+	const std::basic_string_view<Char>& b,
+	const Folder& folder
+) noexcept -> bool {
+	PRECOOKED_ASSERT(a.size() == b.size());
+	if constexpr (std::is_same_v<Char, char>) {
+		if (folder.is_classic()) {
+			return impl_is_equal_ascii_ignore_case(a.data(), b.data(), a.size());
+		}
+	}
+	return impl_is_equal_ignore_case_folded(a, b, folder);
+}
+
 
 
-template <typename Char>
-[[nodiscard]] auto impl_find_ignore_case(
+// Finds needle, the upper and lower case variant of the needle front
+// are precomputed by the caller
+template <typename Char, typename Folder>
+[[nodiscard]] auto impl_find_ignore_case_with_front(
 	const std::basic_string_view<Char>& haystack,
 	const std::basic_string_view<Char>& needle,
 	const size_t offset,
-	const std::locale& loc
+	const Char needle_front_upper,
+	const Char needle_front_lower,
+	const Folder& folder
 ) noexcept -> size_t {
 	PRECOOKED_ASSERT(haystack.size() >= needle.size());
 	PRECOOKED_ASSERT(!needle.empty());
 	constexpr auto npos = std::basic_string_view<Char>::npos;
 	const auto i_end = (1 + haystack.size()) - needle.size(); // No need to search beyond this index
-	//if (offset > i_end) {
-	//	return npos;
-	//}
 	const auto equals_needle_front_f = [
-		upper = std::toupper(needle.front(), loc),
-		lower = std::tolower(needle.front(), loc)
+		upper = needle_front_upper,
+		lower = needle_front_lower
 	](const Char& c) noexcept {
 		return c == upper || c == lower;
 	};
@@ -1280,13 +3574,36 @@ template <typename Char>
 		}
 		PRECOOKED_ASSERT(i + needle.size() <= haystack.size());
 		const auto candidate_tail = haystack.substr(i + 1, needle.size() - 1);
-		if (detail::impl_is_equal_ignore_case(candidate_tail, needle_tail, loc)) {
+		if (detail::impl_is_equal_ignore_case_folded(candidate_tail, needle_tail, folder)) {
 			return i;
 		}
 	}
 	return npos;
 }
 
+template <typename Char, typename Folder>
+[[nodiscard]] auto impl_find_ignore_case(
+	const std::basic_string_view<Char>& haystack,
+	const std::basic_string_view<Char>& needle,
+	const size_t offset,
+	const Folder& folder
+) noexcept -> size_t {
+	PRECOOKED_ASSERT(!needle.empty());
+	if constexpr (std::is_same_v<Char, char>) {
+		if (folder.is_classic()) {
+			return impl_find_ascii_ignore_case(haystack, needle, offset);
+		}
+	}
+	return impl_find_ignore_case_with_front(
+		haystack,
+		needle,
+		offset,
+		folder.to_upper(needle.front()),
+		folder.to_lower(needle.front()),
+		folder
+	);
+}
+
 }
 
 
@@ -1324,6 +3641,23 @@ template <typename Char, typename FindFunc>
 }
 
 
+// Counts the matches from first_match, find_f(offset) returns 
+// the haystack size if there are no further matches
+template <typename FindF>
+[[nodiscard]] auto impl_count_occurances_from(
+	const size_t first_match,
+	const size_t haystack_size,
+	const size_t needle_size,
+	const FindF& find_f
+) noexcept -> size_t {
+	auto num_occurances = size_t{ 0 };
+	for (auto i = first_match; i < haystack_size; i = find_f(i + needle_size)) {
+		++num_occurances;
+	}
+	return num_occurances;
+}
+
+
 template <typename Char>
 auto replace_string_part_inplace(
 	std::basic_string<Char>& io_string, 
@@ -1405,160 +3739,1120 @@ template <typename Char, typename FindFunc>
 
 
 
-// This function builds a new string.
-// - Required if replacement is larger than needle, or the source is a string_view.
-// - It makes at most one allocation.
-template <typename Char, typename FindFunc>
-[[nodiscard]] auto impl_replace_all_rebuild_string(
+// Number of match positions recorded while sizing the result
+constexpr auto num_buffered_matches = size_t{ 64 };
+
+class buffered_matches_t {
+public:
+	std::array<size_t, num_buffered_matches> positions{};
+	size_t count{ 0 };
+	size_t next{ 0 }; // Position of the first unbuffered match, haystack size if none
+	[[nodiscard]] constexpr auto is_complete(const size_t haystack_size) const noexcept { return next == haystack_size; }
+};
+
+// find_f(offset) returns the haystack size if there are no further matches
+template <typename FindF>
+[[nodiscard]] auto impl_buffer_matches(
+	const size_t first_match,
+	const size_t haystack_size,
+	const size_t needle_size,
+	const FindF& find_f
+) noexcept -> buffered_matches_t {
+	auto matches = buffered_matches_t{};
+	matches.next = first_match;
+	while (matches.next < haystack_size && matches.count < matches.positions.size()) {
+		matches.positions[matches.count] = matches.next;
+		++matches.count;
+		matches.next = find_f(matches.next + needle_size);
+	}
+	return matches;
+}
+
+// Modifies the string in-place.
+// - Requires replacement to be larger than needle.
+// - Resizes once, which only allocates if the capacity is insufficient.
+// - If all matches fit the match buffer, the string is shifted from back to 
+//   front. Otherwise the unprocessed tail is moved to the end of the resized 
+//   string and the result is written front to back, the write position never 
+//   passes the read position.
+template <typename Char, typename FindFunc>
+[[nodiscard]] auto impl_replace_all_grow_string(
+	std::basic_string<Char> haystack,
+	const std::basic_string_view<Char> needle,
+	const std::basic_string_view<Char> replacement,
+	const FindFunc& find_func
+) -> std::basic_string<Char> {
+	PRECOOKED_ASSERT(needle.size() < replacement.size());
+	PRECOOKED_ASSERT(!needle.empty());
+	const auto src_size = haystack.size();
+	const auto find_in_f = [&needle, &find_func](const std::basic_string_view<Char>& src, const size_t offset) noexcept {
+		return std::min(find_func(src, needle, offset), src.size());
+	};
+	const auto first_match = find_in_f(haystack, 0);
+	if (first_match >= src_size) PRECOOKED_UNLIKELY {
+		return haystack;
+	}
+	const auto find_f = [&](const size_t offset) noexcept {
+		return find_in_f(haystack, offset);
+	};
+	const auto matches = impl_buffer_matches(first_match, src_size, needle.size(), find_f);
+	const auto num_occurances = matches.count + impl_count_occurances_from(matches.next, src_size, needle.size(), find_f);
+	const auto size_diff = (replacement.size() - needle.size()) * num_occurances;
+	haystack.resize(src_size + size_diff);
+	auto* data = haystack.data();
+	if (matches.is_complete(src_size)) {
+		// Back to front
+		auto src_end = src_size;
+		auto dst_end = haystack.size();
+		for (auto i = matches.count; i-- > 0;) {
+			const auto match = matches.positions[i];
+			const auto tail_begin = match + needle.size();
+			std::copy_backward(data + tail_begin, data + src_end, data + dst_end);
+			dst_end -= src_end - tail_begin;
+			dst_end -= replacement.size();
+			std::copy(replacement.begin(), replacement.end(), data + dst_end);
+			src_end = match;
+		}
+		PRECOOKED_ASSERT(src_end == dst_end);
+		return haystack;
+	}
+	// Move everything from the first match to the end, and
+	// read it through a view positioned as the original string
+	std::copy_backward(data + first_match, data + src_size, data + haystack.size());
+	const auto src = std::basic_string_view<Char>{ data + size_diff, src_size };
+	auto write_pos = first_match;
+	auto read_pos = first_match;
+	const auto append_match_f = [&](const size_t match) noexcept {
+		PRECOOKED_ASSERT(read_pos <= match);
+		PRECOOKED_ASSERT(write_pos <= read_pos + size_diff);
+		// The ranges overlap when the write position has caught up with the read position
+		std::char_traits<Char>::move(data + write_pos, src.data() + read_pos, match - read_pos);
+		write_pos += match - read_pos;
+		std::copy(replacement.begin(), replacement.end(), data + write_pos);
+		write_pos += replacement.size();
+		read_pos = match + needle.size();
+	};
+	for (size_t i = 0; i < matches.count; ++i) {
+		append_match_f(matches.positions[i]);
+	}
+	for (auto match = matches.next; match < src_size; match = find_in_f(src, read_pos)) {
+		append_match_f(match);
+	}
+	// The tail is already in place
+	PRECOOKED_ASSERT(write_pos + (src_size - read_pos) == haystack.size());
+	return haystack;
+}
+
+
+// This function builds a new string.
+// - Required if replacement is larger than needle, or the source is a string_view.
+// - It scans the haystack once. The first matches are buffered in order to size 
+//   the result exactly. If there are more matches than fits the buffer, the size 
+//   is extrapolated from the match density, and a string_builder adds chunks 
+//   if the estimate turns out too small.
+// - It makes one allocation, unless the estimate was too small. Then the chunks 
+//   are copied once into the result.
+template <typename Char, typename FindFunc>
+[[nodiscard]] auto impl_replace_all_rebuild_string(
+	const std::basic_string_view<Char>& haystack,
+	const std::basic_string_view<Char>& needle,
+	const std::basic_string_view<Char>& replacement,
+	const FindFunc& find_func
+) -> std::basic_string<Char> {
+	PRECOOKED_ASSERT(!needle.empty());
+	PRECOOKED_ASSERT(needle.size() <= haystack.size());
+	const auto find_f = [&](const size_t offset) noexcept -> size_t {
+		return std::min(find_func(haystack, needle, offset), haystack.size());
+	};
+	const auto first_match = find_f(0);
+	if (first_match >= haystack.size()) PRECOOKED_UNLIKELY {
+		return std::basic_string<Char>{ haystack };
+	}
+	const auto matches = impl_buffer_matches(first_match, haystack.size(), needle.size(), find_f);
+	const auto num_matches = matches.count;
+	const auto next_match = matches.next;
+	const auto target_size_f = [&](const size_t num_occurances) noexcept -> size_t {
+		return needle.size() <= replacement.size() ?
+			haystack.size() + (replacement.size() - needle.size()) * num_occurances :
+			haystack.size() - (needle.size() - replacement.size()) * num_occurances;
+	};
+	const auto is_all_matches_buffered = matches.is_complete(haystack.size());
+	const auto estimated_target_size_f = [&]() noexcept -> size_t {
+		if (replacement.size() <= needle.size()) {
+			return haystack.size(); // Upper bound
+		}
+		const auto num_found = num_matches + 1;
+		const auto num_scanned = next_match + needle.size();
+		const auto max_occurances = haystack.size() / needle.size();
+		const auto extrapolated = (num_found * haystack.size()) / num_scanned;
+		return target_size_f(std::min(extrapolated + extrapolated / 8, max_occurances));
+	};
+	const auto reserve_size = is_all_matches_buffered ?
+		target_size_f(num_matches) :
+		estimated_target_size_f();
+	auto ret = basic_string_builder<Char>{ reserve_size };
+	auto left = size_t{ 0 };
+	const auto append_match_f = [&](const size_t right) {
+		PRECOOKED_ASSERT(left <= right);
+		PRECOOKED_ASSERT(right < haystack.size());
+		ret.append(haystack.substr(left, right - left));
+		ret.append(replacement);
+		left = right + needle.size();
+	};
+	for (size_t i = 0; i < num_matches; ++i) {
+		append_match_f(matches.positions[i]);
+	}
+	for (auto right = next_match; right < haystack.size(); right = find_f(left)) {
+		append_match_f(right);
+	}
+	PRECOOKED_ASSERT(left <= haystack.size());
+	ret.append(haystack.substr(left));
+	PRECOOKED_ASSERT(!is_all_matches_buffered || ret.size() == reserve_size);
+	return ret.finish();
+}
+
+
+// Picks implementation based on needle/replacement size
+template <typename Char, typename FindFunc>
+[[nodiscard]] auto impl_replace_all(
+	std::basic_string<Char> haystack,
+	const std::basic_string_view<Char> needle,
+	const std::basic_string_view<Char> replacement,
+	const FindFunc& find_func
+) -> std::basic_string<Char> {
+	const auto no_replacement_possible =
+		needle.empty() ||
+		needle.size() > haystack.size();
+	return
+		no_replacement_possible ? haystack :
+		needle.length() == replacement.length() ? impl_replace_all_equal_needle_length(std::move(haystack), needle, replacement, find_func) :
+		replacement.length() < needle.length() ? impl_replace_all_shrink_string(std::move(haystack), needle, replacement, find_func) :
+		impl_replace_all_grow_string(std::move(haystack), needle, replacement, find_func);
+}
+
+template <typename Char, typename FindFunc>
+[[nodiscard]] auto impl_replace_all_view(
+	const std::basic_string_view<Char> haystack,
+	const std::basic_string_view<Char> needle,
+	const std::basic_string_view<Char> replacement,
+	const FindFunc& find_func
+) -> std::basic_string<Char> {
+	const auto no_replacement_possible =
+		needle.empty() ||
+		needle.size() > haystack.size();
+	return no_replacement_possible ?
+		std::basic_string<Char>{ haystack } :
+		impl_replace_all_rebuild_string(haystack, needle, replacement, find_func);
+}
+
+}
+
+template <typename Char, typename Str0, typename Str1>
+auto peo::replace_all(
+	std::basic_string<Char> haystack, 
+	const Str0& needle, 
+	const Str1& replacement
+) -> std::basic_string<Char> {
+	const auto needle_sv = std::basic_string_view<Char>{ needle };
+	const auto replacement_sv = std::basic_string_view<Char>{ replacement };
+	const auto& find_func = detail::find_case_sensitive_f;
+	return detail::impl_replace_all(std::move(haystack), needle_sv, replacement_sv, find_func);
+}
+
+
+template <typename Str0, typename Str1, typename Str2>
+auto peo::replace_all(
+	const Str0& haystack, 
+	const Str1& needle, 
+	const Str2& replacement
+) -> std::basic_string<type_traits::underlying_char_t<Str0>> {
+	using Char = type_traits::underlying_char_t<Str0>;
+	static_assert(type_traits::is_valid_char_v<Char>);
+	const auto haystack_sv = std::basic_string_view<Char>{ haystack };
+	const auto needle_sv = std::basic_string_view<Char>{ needle };
+	const auto replacement_sv = std::basic_string_view<Char>{ replacement };
+	const auto& find_func = detail::find_case_sensitive_f;
+	return detail::impl_replace_all_view(haystack_sv, needle_sv, replacement_sv, find_func);
+}
+
+
+template <typename Char, typename Str0, typename Str1>
+auto peo::replace_all_ignore_case(
+	std::basic_string<Char> haystack, 
+	const Str0& needle, 
+	const Str1& replacement,
+	const std::locale& loc
+) -> std::basic_string<Char> {
+	static_assert(type_traits::is_valid_char_v<Char>);
+	const auto needle_sv = std::basic_string_view<Char>{ needle };
+	const auto replacement_sv = std::basic_string_view<Char>{ replacement };
+	const auto folder = detail::locale_folder{ loc };
+	const auto& find_func = [&folder](const auto& haystack, const auto& needle, size_t offset) noexcept {
+		return detail::impl_find_ignore_case<Char>(haystack, needle, offset, folder);
+	};
+	return detail::impl_replace_all(std::move(haystack), needle_sv, replacement_sv, find_func);
+}
+
+template <typename Str0, typename Str1, typename Str2>
+auto peo::replace_all_ignore_case(
+	const Str0& haystack, 
+	const Str1& needle, 
+	const Str2& replacement, 
+	const std::locale& loc
+) -> std::basic_string<type_traits::underlying_char_t<Str0>> {
+	using Char = type_traits::underlying_char_t<Str0>;
+	static_assert(type_traits::is_valid_char_v<Char>);
+	const auto haystack_sv = std::basic_string_view<Char>{ haystack };
+	const auto needle_sv = std::basic_string_view<Char>{ needle };
+	const auto replacement_sv = std::basic_string_view<Char>{ replacement };
+	const auto folder = detail::locale_folder{ loc };
+	const auto& find_func = [&folder](const auto& haystack, const auto& needle, size_t offset) noexcept {
+		return detail::impl_find_ignore_case<Char>(haystack, needle, offset, folder);
+	};
+	return detail::impl_replace_all_view(haystack_sv, needle_sv, replacement_sv, find_func);
+}
+
+template <typename Char, typename Str0, typename Str1>
+auto peo::replace_all_ignore_case(
+	std::basic_string<Char> haystack, 
+	const Str0& needle, 
+	const Str1& replacement,
+	const case_folder& folder
+) -> std::basic_string<Char> {
+	static_assert(type_traits::is_valid_char_v<Char>);
+	const auto needle_sv = std::basic_string_view<Char>{ needle };
+	const auto replacement_sv = std::basic_string_view<Char>{ replacement };
+	const auto& find_func = [&folder](const auto& haystack, const auto& needle, size_t offset) noexcept {
+		return detail::impl_find_ignore_case<Char>(haystack, needle, offset, folder);
+	};
+	return detail::impl_replace_all(std::move(haystack), needle_sv, replacement_sv, find_func);
+}
+
+template <typename Str0, typename Str1, typename Str2>
+auto peo::replace_all_ignore_case(
+	const Str0& haystack, 
+	const Str1& needle, 
+	const Str2& replacement, 
+	const case_folder& folder
+) -> std::basic_string<type_traits::underlying_char_t<Str0>> {
+	using Char = type_traits::underlying_char_t<Str0>;
+	static_assert(type_traits::is_valid_char_v<Char>);
+	const auto haystack_sv = std::basic_string_view<Char>{ haystack };
+	const auto needle_sv = std::basic_string_view<Char>{ needle };
+	const auto replacement_sv = std::basic_string_view<Char>{ replacement };
+	const auto& find_func = [&folder](const auto& haystack, const auto& needle, size_t offset) noexcept {
+		return detail::impl_find_ignore_case<Char>(haystack, needle, offset, folder);
+	};
+	return detail::impl_replace_all_view(haystack_sv, needle_sv, replacement_sv, find_func);
+}
+
+
+
+
+
+
+
+
+
+
+
+
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+// Parallel replace
+
+#include <algorithm>
+
+namespace peo::detail {
+
+// Matches are searched for in chunks concurrently, a match belongs to the chunk 
+// where it starts. A chunk is rescanned sequentially if a match of a previous 
+// chunk extends into it, until it coincides with the concurrent result again. 
+// The output offsets of the chunks are then given by a prefix sum, and the 
+// chunks are written concurrently into a single allocated result.
+template <typename Char, typename FindFunc>
+[[nodiscard]] auto impl_replace_all_parallel(
+	const std::basic_string_view<Char> haystack,
+	const std::basic_string_view<Char> needle,
+	const std::basic_string_view<Char> replacement,
+	const FindFunc& find_func,
+	const size_t num_threads
+) -> std::basic_string<Char> {
+	PRECOOKED_ASSERT(!needle.empty());
+	PRECOOKED_ASSERT(needle.size() <= haystack.size());
+	const auto chunk_size = std::max({
+		(haystack.size() + num_threads * 4 - 1) / (num_threads * 4),
+		parallel_min_chunk_size,
+		needle.size()
+	});
+	const auto num_chunks = (haystack.size() + chunk_size - 1) / chunk_size;
+	const auto chunk_begin_f = [&](const size_t chunk) noexcept {
+		return std::min(chunk * chunk_size, haystack.size());
+	};
+	// Searches only the window of matches starting before chunk_end, returns chunk_end if none
+	const auto find_f = [&](const size_t offset, const size_t chunk_end) noexcept -> size_t {
+		const auto window = haystack.substr(0, std::min(haystack.size(), chunk_end + needle.size() - 1));
+		if (offset >= window.size()) {
+			return chunk_end;
+		}
+		return std::min(find_func(window, needle, offset), chunk_end);
+	};
+	// Find matches concurrently
+	auto matches = std::vector<std::vector<size_t>>(num_chunks);
+	impl_parallel_for(num_chunks, num_threads, [&](const size_t chunk) {
+		const auto chunk_begin = chunk_begin_f(chunk);
+		const auto chunk_end = chunk_begin_f(chunk + 1);
+		for (auto match = find_f(chunk_begin, chunk_end); match < chunk_end; match = find_f(match + needle.size(), chunk_end)) {
+			matches[chunk].push_back(match);
+		}
+	});
+	// Resynchronize chunks overlapped by a match of the previous chunk
+	auto input_begins = std::vector<size_t>(num_chunks + 1, haystack.size());
+	auto prev_match_end = size_t{ 0 };
+	for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+		const auto chunk_begin = chunk_begin_f(chunk);
+		const auto chunk_end = chunk_begin_f(chunk + 1);
+		auto& chunk_matches = matches[chunk];
+		input_begins[chunk] = std::max(chunk_begin, prev_match_end);
+		const auto is_overlapped = !chunk_matches.empty() && chunk_matches.front() < prev_match_end;
+		if (is_overlapped) {
+			auto resynced = std::vector<size_t>{};
+			auto match = find_f(prev_match_end, chunk_end);
+			for (; match < chunk_end; match = find_f(match + needle.size(), chunk_end)) {
+				const auto it = std::lower_bound(chunk_matches.begin(), chunk_matches.end(), match);
+				if (it != chunk_matches.end() && *it == match) {
+					resynced.insert(resynced.end(), it, chunk_matches.end());
+					break;
+				}
+				resynced.push_back(match);
+			}
+			chunk_matches = std::move(resynced);
+		}
+		if (!chunk_matches.empty()) {
+			prev_match_end = chunk_matches.back() + needle.size();
+		}
+	}
+	// Output offsets by prefix sum
+	auto output_offsets = std::vector<size_t>(num_chunks + 1, 0);
+	for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+		const auto num_matches = matches[chunk].size();
+		const auto input_size = input_begins[chunk + 1] - input_begins[chunk];
+		const auto output_size = input_size - num_matches * needle.size() + num_matches * replacement.size();
+		output_offsets[chunk + 1] = output_offsets[chunk] + output_size;
+	}
+	auto ret = std::basic_string<Char>{};
+	ret.resize(output_offsets.back());
+	// Write chunks concurrently
+	impl_parallel_for(num_chunks, num_threads, [&](const size_t chunk) noexcept {
+		auto* dst = ret.data() + output_offsets[chunk];
+		auto left = input_begins[chunk];
+		for (auto&& match : matches[chunk]) {
+			PRECOOKED_ASSERT(left <= match);
+			dst = std::copy(haystack.begin() + left, haystack.begin() + match, dst);
+			dst = std::copy(replacement.begin(), replacement.end(), dst);
+			left = match + needle.size();
+		}
+		dst = std::copy(haystack.begin() + left, haystack.begin() + input_begins[chunk + 1], dst);
+		PRECOOKED_ASSERT(dst == ret.data() + output_offsets[chunk + 1]);
+	});
+	return ret;
+}
+}
+
+template <typename Str0, typename Str1, typename Str2>
+auto peo::replace_all_parallel(
+	const Str0& haystack, 
+	const Str1& needle, 
+	const Str2& replacement,
+	const size_t num_threads
+) -> std::basic_string<type_traits::underlying_char_t<Str0>> {
+	using Char = type_traits::underlying_char_t<Str0>;
+	static_assert(type_traits::is_valid_char_v<Char>);
+	const auto haystack_sv = std::basic_string_view<Char>{ haystack };
+	const auto needle_sv = std::basic_string_view<Char>{ needle };
+	const auto replacement_sv = std::basic_string_view<Char>{ replacement };
+	const auto& find_func = detail::find_case_sensitive_f;
+	const auto num_threads_resolved = detail::resolve_num_threads(num_threads);
+	const auto is_parallel = 
+		num_threads_resolved > 1 && 
+		haystack_sv.size() >= detail::parallel_min_size &&
+		!needle_sv.empty() &&
+		needle_sv.size() <= haystack_sv.size();
+	return is_parallel ?
+		detail::impl_replace_all_parallel(haystack_sv, needle_sv, replacement_sv, find_func, num_threads_resolved) :
+		detail::impl_replace_all_view(haystack_sv, needle_sv, replacement_sv, find_func);
+}
+
+
+
+
+
+
+
+
+
+
+
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+// Precompiled searchers
+
+namespace peo::detail {
+using skip_table_t = std::array<size_t, 256>;
+
+template <typename Char>
+[[nodiscard]] constexpr auto skip_table_idx(const Char c) noexcept -> size_t {
+	using uchar_t = std::make_unsigned_t<Char>;
+	// Wider chars share buckets by their low byte, which only makes the skips shorter
+	return static_cast<size_t>(static_cast<uchar_t>(c)) & 0xff;
+}
+
+// Boyer-Moore-Horspool, the window comparison is made by is_window_match_f(idx)
+template <typename Char, typename IsWindowMatch>
+[[nodiscard]] auto impl_find_horspool(
 	const std::basic_string_view<Char>& haystack,
-	const std::basic_string_view<Char>& needle,
-	const std::basic_string_view<Char>& replacement,
-	const FindFunc& find_func
-) -> std::basic_string<Char> {
-	PRECOOKED_ASSERT(!needle.empty());
-	PRECOOKED_ASSERT(needle.size() <= haystack.size());
-	const auto first_match = std::min(find_func(haystack, needle, 0), haystack.size());
-	if (first_match >= haystack.size()) PRECOOKED_UNLIKELY {
-		return std::basic_string<Char>{ haystack };
+	const size_t needle_size,
+	const size_t offset,
+	const skip_table_t& skip_table,
+	const IsWindowMatch& is_window_match_f
+) noexcept -> size_t {
+	PRECOOKED_ASSERT(needle_size > 0);
+	constexpr auto npos = std::basic_string_view<Char>::npos;
+	if (needle_size > haystack.size()) {
+		return npos;
 	}
-	const auto lazy_num_occurances_f = [&]() noexcept {
-		const auto num_occurances = impl_count_occurances(
-			haystack,
-			needle,
-			first_match + needle.size(),
-			find_func
-		);
-		return num_occurances + 1; // first_match found indicates one occurances
-	};
-	const auto target_size =
-		needle.size() < replacement.size() ? haystack.size() + (replacement.size() - needle.size()) * lazy_num_occurances_f() :
-		replacement.size() < needle.size() ? haystack.size() - (needle.size() - replacement.size()) * lazy_num_occurances_f() :
-		haystack.size();
-		
-	auto ret = std::basic_string<Char>{};
-	ret.reserve(target_size);
+	const auto i_last = haystack.size() - needle_size;
 	for (
-		size_t left = 0, right = first_match;
-		;
-		right = std::min(find_func(haystack, needle, left), haystack.size())
+		auto i = offset; 
+		i <= i_last; 
+		i += skip_table[skip_table_idx(haystack[i + needle_size - 1])]
 	) {
-		PRECOOKED_ASSERT(left <= right);
-		PRECOOKED_ASSERT(right <= haystack.size());
-		ret += haystack.substr(left, right - left);
-		if (right == haystack.size()) {
-			break;
+		if (is_window_match_f(i)) {
+			return i;
 		}
-		PRECOOKED_ASSERT(right < haystack.size());
-		ret += replacement;
-		left = right + needle.size();
 	}
-	PRECOOKED_ASSERT(ret.size() == target_size);
-	return ret;
+	return npos;
 }
 
+template <typename Char, typename Searcher>
+[[nodiscard]] auto impl_searcher_count(
+	const Searcher& searcher,
+	const std::basic_string_view<Char>& haystack
+) noexcept -> size_t {
+	const auto needle = searcher.needle();
+	if (needle.empty() || needle.size() > haystack.size()) {
+		return 0;
+	}
+	return impl_count_occurances(haystack, needle, size_t{ 0 }, searcher);
 }
 
-template <typename Char, typename Str0, typename Str1>
+template <typename Char, typename Searcher>
+[[nodiscard]] auto impl_searcher_find_all(
+	const Searcher& searcher,
+	const std::basic_string_view<Char>& haystack
+) -> std::vector<size_t> {
+	constexpr auto npos = std::basic_string_view<Char>::npos;
+	const auto needle = searcher.needle();
+	auto positions = std::vector<size_t>{};
+	if (needle.empty()) {
+		return positions;
+	}
+	for (
+		auto idx = searcher.find(haystack, 0);
+		idx != npos;
+		idx = searcher.find(haystack, idx + needle.size())
+	) {
+		positions.push_back(idx);
+	}
+	return positions;
+}
+}
+
+
+template <typename Char>
+class peo::searcher {
+public:
+	static_assert(type_traits::is_valid_char_v<Char>);
+	template <typename Str>
+	explicit searcher(const Str& needle)
+	: needle_{ std::basic_string_view<Char>{ needle } } {
+		const auto m = needle_.size();
+		skip_table_.fill(m);
+		for (size_t i = 0; i + 1 < m; ++i) {
+			skip_table_[detail::skip_table_idx(needle_[i])] = m - 1 - i;
+		}
+	}
+	[[nodiscard]] auto needle() const noexcept -> std::basic_string_view<Char> { return needle_; }
+	// An empty needle never matches
+	[[nodiscard]] auto find(
+		const std::basic_string_view<Char> haystack, 
+		const size_t offset = 0
+	) const noexcept -> size_t {
+		constexpr auto npos = std::basic_string_view<Char>::npos;
+		const auto needle = std::basic_string_view<Char>{ needle_ };
+		if (needle.empty()) PRECOOKED_UNLIKELY {
+			return npos;
+		}
+		if (needle.size() < horspool_min_needle_size) {
+			return haystack.find(needle, offset);
+		}
+		using traits_t = std::char_traits<Char>;
+		const auto is_window_match_f = [&haystack, &needle](const size_t i) noexcept {
+			return 
+				haystack[i + needle.size() - 1] == needle.back() &&
+				traits_t::compare(haystack.data() + i, needle.data(), needle.size() - 1) == 0;
+		};
+		return detail::impl_find_horspool(haystack, needle.size(), offset, skip_table_, is_window_match_f);
+	}
+	[[nodiscard]] auto contains(const std::basic_string_view<Char> haystack) const noexcept -> bool {
+		return find(haystack) != std::basic_string_view<Char>::npos;
+	}
+	// Does not count overlapping occurances
+	[[nodiscard]] auto count(const std::basic_string_view<Char> haystack) const noexcept -> size_t {
+		return detail::impl_searcher_count(*this, haystack);
+	}
+	// Positions of non-overlapping occurances
+	[[nodiscard]] auto find_all(const std::basic_string_view<Char> haystack) const -> std::vector<size_t> {
+		return detail::impl_searcher_find_all(*this, haystack);
+	}
+	// FindFunc interface, the needle argument has to be the needle of the searcher
+	[[nodiscard]] auto operator()(
+		const std::basic_string_view<Char> haystack, 
+		[[maybe_unused]] const std::basic_string_view<Char> needle,
+		const size_t offset
+	) const noexcept -> size_t {
+		PRECOOKED_ASSERT(needle == needle_);
+		return find(haystack, offset);
+	}
+private:
+	// Shorter needles are faster found with std::basic_string_view::find
+	static constexpr auto horspool_min_needle_size = size_t{ 4 };
+	std::basic_string<Char> needle_{};
+	detail::skip_table_t skip_table_{};
+};
+
+
+template <typename Char>
+class peo::searcher_ignore_case {
+public:
+	static_assert(type_traits::is_valid_char_v<Char>);
+	template <typename Str>
+	explicit searcher_ignore_case(const Str& needle, const std::locale& loc = std::locale{})
+	: searcher_ignore_case{ needle, case_folder{ loc } }
+	{}
+	template <typename Str>
+	searcher_ignore_case(const Str& needle, const case_folder& folder)
+	: needle_{ std::basic_string_view<Char>{ needle } }
+	, folder_{ folder } {
+		if (needle_.empty()) {
+			return;
+		}
+		front_upper_ = folder_.to_upper(needle_.front());
+		front_lower_ = folder_.to_lower(needle_.front());
+		if constexpr (std::is_same_v<Char, char>) {
+			// The folder tabulates the chars of the locale, which 
+			// makes a case insensitive Boyer-Moore-Horspool possible
+			const auto m = needle_.size();
+			skip_table_.fill(m);
+			for (size_t i = 0; i + 1 < m; ++i) {
+				for (size_t c = 0; c < skip_table_.size(); ++c) {
+					if (is_char_match(i, static_cast<char>(c))) {
+						skip_table_[c] = m - 1 - i;
+					}
+				}
+			}
+		}
+	}
+	[[nodiscard]] auto needle() const noexcept -> std::basic_string_view<Char> { return needle_; }
+	// Matches exactly like peo::find_ignore_case
+	[[nodiscard]] auto find(
+		const std::basic_string_view<Char> haystack,
+		const size_t offset = 0
+	) const noexcept -> size_t {
+		constexpr auto npos = std::basic_string_view<Char>::npos;
+		const auto needle = std::basic_string_view<Char>{ needle_ };
+		if (needle.empty() || haystack.size() < needle.size()) PRECOOKED_UNLIKELY {
+			return npos;
+		}
+		if constexpr (std::is_same_v<Char, char>) {
+			const auto is_window_match_f = [this, &haystack, &needle](const size_t i) noexcept {
+				for (size_t j = 0; j < needle.size(); ++j) {
+					if (!is_char_match(j, haystack[i + j])) PRECOOKED_LIKELY {
+						return false;
+					}
+				}
+				return true;
+			};
+			return detail::impl_find_horspool(haystack, needle.size(), offset, skip_table_, is_window_match_f);
+		}
+		else {
+			return detail::impl_find_ignore_case_with_front(
+				haystack, 
+				needle, 
+				offset, 
+				front_upper_, 
+				front_lower_, 
+				folder_
+			);
+		}
+	}
+	[[nodiscard]] auto contains(const std::basic_string_view<Char> haystack) const noexcept -> bool {
+		return find(haystack) != std::basic_string_view<Char>::npos;
+	}
+	// Does not count overlapping occurances
+	[[nodiscard]] auto count(const std::basic_string_view<Char> haystack) const noexcept -> size_t {
+		return detail::impl_searcher_count(*this, haystack);
+	}
+	// Positions of non-overlapping occurances
+	[[nodiscard]] auto find_all(const std::basic_string_view<Char> haystack) const -> std::vector<size_t> {
+		return detail::impl_searcher_find_all(*this, haystack);
+	}
+	// FindFunc interface, the needle argument has to be the needle of the searcher
+	[[nodiscard]] auto operator()(
+		const std::basic_string_view<Char> haystack,
+		[[maybe_unused]] const std::basic_string_view<Char> needle,
+		const size_t offset
+	) const noexcept -> size_t {
+		PRECOOKED_ASSERT(needle == needle_);
+		return find(haystack, offset);
+	}
+private:
+	// Same comparison as detail::impl_find_ignore_case, using the tabulated locale
+	[[nodiscard]] auto is_char_match(const size_t needle_idx, const char c) const noexcept -> bool {
+		static_assert(std::is_same_v<Char, char>);
+		const auto needle_char = needle_[needle_idx];
+		return needle_idx == 0 ?
+			c == front_upper_ || c == front_lower_ :
+			c == needle_char || folder_.to_lower(c) == folder_.to_lower(needle_char);
+	}
+	std::basic_string<Char> needle_{};
+	case_folder folder_{};
+	Char front_upper_{};
+	Char front_lower_{};
+	// Only utilized for char
+	detail::skip_table_t skip_table_{};
+};
+
+namespace peo {
+template <typename Str> searcher(const Str&) -> searcher<type_traits::underlying_char_t<Str>>;
+template <typename Str> searcher_ignore_case(const Str&) -> searcher_ignore_case<type_traits::underlying_char_t<Str>>;
+template <typename Str> searcher_ignore_case(const Str&, const std::locale&) -> searcher_ignore_case<type_traits::underlying_char_t<Str>>;
+template <typename Str> searcher_ignore_case(const Str&, const case_folder&) -> searcher_ignore_case<type_traits::underlying_char_t<Str>>;
+}
+
+
+template <typename Char, typename Str0>
 auto peo::replace_all(
-	std::basic_string<Char> haystack, 
-	const Str0& needle, 
-	const Str1& replacement
+	std::basic_string<Char> haystack,
+	const searcher<Char>& needle,
+	const Str0& replacement
 ) -> std::basic_string<Char> {
-	// Pick implementation based on needle/replacement size
-	const auto haystack_sv = std::basic_string_view<Char>{ haystack };
-	const auto needle_sv = std::basic_string_view<Char>{ needle };
 	const auto replacement_sv = std::basic_string_view<Char>{ replacement };
-	const auto& find_func = detail::find_case_sensitive_f;
-	const auto no_replacement_possible = 
-		needle_sv.empty() || 
-		needle_sv.size() > haystack_sv.size();
-	return
-		no_replacement_possible ? haystack :
-		needle_sv.length() == replacement_sv.length() ? detail::impl_replace_all_equal_needle_length(std::move(haystack), needle_sv, replacement_sv, find_func) :
-		replacement_sv.length() < needle_sv.length() ? detail::impl_replace_all_shrink_string(std::move(haystack), needle_sv, replacement_sv, find_func) :
-		detail::impl_replace_all_rebuild_string<Char>(haystack, needle_sv, replacement_sv, find_func);
+	return detail::impl_replace_all(std::move(haystack), needle.needle(), replacement_sv, needle);
 }
 
-
-template <typename Str0, typename Str1, typename Str2>
+template <typename Str0, typename Char, typename Str1>
 auto peo::replace_all(
-	const Str0& haystack, 
-	const Str1& needle, 
-	const Str2& replacement
-) -> std::basic_string<type_traits::underlying_char_t<Str0>> {
-	using Char = type_traits::underlying_char_t<Str0>;
-	static_assert(type_traits::is_valid_char_v<Char>);
+	const Str0& haystack,
+	const searcher<Char>& needle,
+	const Str1& replacement
+) -> std::basic_string<Char> {
 	const auto haystack_sv = std::basic_string_view<Char>{ haystack };
-	const auto needle_sv = std::basic_string_view<Char>{ needle };
 	const auto replacement_sv = std::basic_string_view<Char>{ replacement };
-	const auto& find_func = detail::find_case_sensitive_f;
-	const auto no_replacement_possible = 
-		needle_sv.empty() || 
-		needle_sv.size() > haystack_sv.size();
-	return no_replacement_possible ?
-		std::basic_string<Char>{ haystack_sv } :
-		detail::impl_replace_all_rebuild_string(haystack_sv, needle_sv, replacement_sv, find_func);
+	return detail::impl_replace_all_view(haystack_sv, needle.needle(), replacement_sv, needle);
 }
 
-
-template <typename Char, typename Str0, typename Str1>
-auto peo::replace_all_ignore_case(
-	std::basic_string<Char> haystack, 
-	const Str0& needle, 
-	const Str1& replacement,
-	const std::locale& loc
+template <typename Char, typename Str0>
+auto peo::replace_all(
+	std::basic_string<Char> haystack,
+	const searcher_ignore_case<Char>& needle,
+	const Str0& replacement
 ) -> std::basic_string<Char> {
-	static_assert(type_traits::is_valid_char_v<Char>);
-	const auto haystack_sv = std::basic_string_view<Char>{ haystack };
-	const auto needle_sv = std::basic_string_view<Char>{ needle };
 	const auto replacement_sv = std::basic_string_view<Char>{ replacement };
-	const auto& find_func = [&loc](const auto& haystack, const auto& needle, size_t offset) noexcept {
-		return detail::impl_find_ignore_case<Char>(haystack, needle, offset, loc);
-	};
-	const auto no_replacement_possible = 
-		needle_sv.empty() || 
-		needle_sv.size() > haystack_sv.size();
-	return
-		no_replacement_possible ? haystack :
-		needle_sv.length() == replacement_sv.length() ? detail::impl_replace_all_equal_needle_length(std::move(haystack), needle_sv, replacement_sv, find_func) :
-		replacement_sv.length() < needle_sv.length() ? detail::impl_replace_all_shrink_string(std::move(haystack), needle_sv, replacement_sv, find_func) :
-		detail::impl_replace_all_rebuild_string<Char>(haystack_sv, needle_sv, replacement_sv, find_func);
+	return detail::impl_replace_all(std::move(haystack), needle.needle(), replacement_sv, needle);
 }
 
-template <typename Str0, typename Str1, typename Str2>
-auto peo::replace_all_ignore_case(
-	const Str0& haystack, 
-	const Str1& needle, 
-	const Str2& replacement, 
-	const std::locale& loc
-) -> std::basic_string<type_traits::underlying_char_t<Str0>> {
-	using Char = type_traits::underlying_char_t<Str0>;
-	static_assert(type_traits::is_valid_char_v<Char>);
+template <typename Str0, typename Char, typename Str1>
+auto peo::replace_all(
+	const Str0& haystack,
+	const searcher_ignore_case<Char>& needle,
+	const Str1& replacement
+) -> std::basic_string<Char> {
 	const auto haystack_sv = std::basic_string_view<Char>{ haystack };
-	const auto needle_sv = std::basic_string_view<Char>{ needle };
 	const auto replacement_sv = std::basic_string_view<Char>{ replacement };
-	const auto& find_func = [&loc](const auto& haystack, const auto& needle, size_t offset) noexcept {
-		return detail::impl_find_ignore_case<Char>(haystack, needle, offset, loc);
-	};
-	const auto no_replacement_possible =
-		needle_sv.empty() || 
-		needle_sv.size() > haystack_sv.size();
-	return no_replacement_possible ?
-		std::basic_string<Char>{ haystack_sv } :
-		detail::impl_replace_all_rebuild_string(haystack_sv, needle_sv, replacement_sv, find_func);
+	return detail::impl_replace_all_view(haystack_sv, needle.needle(), replacement_sv, needle);
 }
 
 
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
 
 
+#include <cstring>
+#include <initializer_list>
+#include <limits>
 
+// Finds any of a set of needles in a single pass. Up to 32 needles are found with 
+// a Teddy fingerprint filter when SSSE3 is available, candidate positions are those 
+// whose first (up to 3) chars may begin a needle, judged 16 positions at a time 
+// by nibble lookups. Otherwise an Aho-Corasick automaton over byte classes is used.
+// IgnoreCase folds ASCII letters like the classic locale. Empty needles never match.
+template <bool IgnoreCase>
+class peo::basic_multi_searcher {
+public:
+	struct match_t {
+		size_t offset{ 0 };
+		size_t needle_idx{ 0 };
+	};
+	template <typename Strings>
+	explicit basic_multi_searcher(const Strings& needles) {
+		for (const auto& needle : needles) {
+			needles_.emplace_back(std::string_view{ needle });
+		}
+		build();
+	}
+	basic_multi_searcher(std::initializer_list<std::string_view> needles)
+	: needles_(needles.begin(), needles.end()) {
+		build();
+	}
 
+	[[nodiscard]] auto num_needles() const noexcept -> size_t { return needles_.size(); }
+	[[nodiscard]] auto needle(const size_t idx) const noexcept -> std::string_view { 
+		PRECOOKED_ASSERT(idx < needles_.size());
+		return needles_[idx]; 
+	}
+	[[nodiscard]] auto contains_any(const std::string_view haystack) const noexcept -> bool {
+		return find_first(haystack).has_value();
+	}
+	// The leftmost match, of the lowest needle index if several needles start there
+	[[nodiscard]] auto find_first(
+		const std::string_view haystack, 
+		const size_t offset = 0
+	) const noexcept -> std::optional<match_t> {
+		if (max_needle_size_ == 0 || offset >= haystack.size()) {
+			return std::nullopt;
+		}
+#if PRECOOKED_SSSE3
+		if (is_teddy_) {
+			// Teddy reports matches by offset, and then by needle index
+			auto result = std::optional<match_t>{};
+			teddy_for_each(haystack, offset, [&result](const match_t& match) noexcept {
+				result = match;
+				return false;
+			});
+			return result;
+		}
+#endif
+		return automaton_find_first(haystack, offset);
+	}
+	// Invokes func(match_t) for every match, including overlapping ones, in unspecified order
+	template <typename Func>
+	auto for_each_match(const std::string_view haystack, const Func& func) const -> void {
+		if (max_needle_size_ == 0) {
+			return;
+		}
+		const auto continue_f = [&func](const match_t& match) {
+			func(match);
+			return true;
+		};
+#if PRECOOKED_SSSE3
+		if (is_teddy_) {
+			teddy_for_each(haystack, 0, continue_f);
+			return;
+		}
+#endif
+		automaton_for_each(haystack, 0, continue_f);
+	}
 
+private:
+	static constexpr auto max_teddy_needles = size_t{ 32 };
+	static constexpr auto num_teddy_buckets = size_t{ 8 };
+	static constexpr auto max_fingerprint_size = size_t{ 3 };
+	static constexpr auto no_state = uint32_t{ 0xFFFFFFFF };
 
+	[[nodiscard]] static constexpr auto fold(const char c) noexcept -> char {
+		return IgnoreCase ? detail::ascii_to_lower(c) : c;
+	}
+	[[nodiscard]] static constexpr auto to_idx(const char c) noexcept -> size_t {
+		return static_cast<unsigned char>(c);
+	}
+	[[nodiscard]] auto is_match_at(
+		const std::string_view haystack, 
+		const size_t offset, 
+		const size_t needle_idx
+	) const noexcept -> bool {
+		const auto& needle = needles_[needle_idx];
+		PRECOOKED_ASSERT(offset < haystack.size());
+		if (needle.empty() || haystack.size() - offset < needle.size()) {
+			return false;
+		}
+		return IgnoreCase ?
+			detail::impl_is_equal_ascii_ignore_case(haystack.data() + offset, needle.data(), needle.size()) :
+			std::memcmp(haystack.data() + offset, needle.data(), needle.size()) == 0;
+	}
 
+	auto build() -> void {
+		auto num_nonempty = size_t{ 0 };
+		min_needle_size_ = std::numeric_limits<size_t>::max();
+		for (const auto& needle : needles_) {
+			if (!needle.empty()) {
+				++num_nonempty;
+				min_needle_size_ = std::min(min_needle_size_, needle.size());
+				max_needle_size_ = std::max(max_needle_size_, needle.size());
+			}
+		}
+		if (num_nonempty == 0) {
+			return;
+		}
+#if PRECOOKED_SSSE3
+		if (num_nonempty <= max_teddy_needles) {
+			build_teddy(num_nonempty);
+			return;
+		}
+#endif
+		build_automaton();
+	}
 
+	// Teddy
+#if PRECOOKED_SSSE3
+	auto build_teddy(const size_t num_nonempty) -> void {
+		is_teddy_ = true;
+		fingerprint_size_ = std::min(min_needle_size_, max_fingerprint_size);
+		// Consecutive needles share buckets, so buckets are visited in needle index order
+		auto nonempty_idx = size_t{ 0 };
+		for (size_t idx = 0; idx < needles_.size(); ++idx) {
+			const auto& needle = needles_[idx];
+			if (needle.empty()) {
+				continue;
+			}
+			const auto bucket = nonempty_idx++ * num_teddy_buckets / num_nonempty;
+			bucket_needles_[bucket].push_back(idx);
+			const auto bucket_bit = static_cast<uint8_t>(1u << bucket);
+			for (size_t k = 0; k < fingerprint_size_; ++k) {
+				const auto add_char_f = [&](const char c) noexcept {
+					lo_masks_[k][to_idx(c) & 0x0F] |= bucket_bit;
+					hi_masks_[k][to_idx(c) >> 4] |= bucket_bit;
+				};
+				add_char_f(needle[k]);
+				if constexpr (IgnoreCase) {
+					add_char_f(detail::ascii_to_lower(needle[k]));
+					add_char_f(detail::ascii_to_upper(needle[k]));
+				}
+			}
+		}
+	}
+	// Invokes on_match_f(match_t) by increasing offset, until it returns false
+	template <typename OnMatchF>
+	auto teddy_for_each(
+		const std::string_view haystack, 
+		const size_t offset, 
+		const OnMatchF& on_match_f
+	) const -> void {
+		const auto low_nibble_mask = _mm_set1_epi8(0x0F);
+		const auto block_reach = 16 + fingerprint_size_ - 1;
+		char tail[16 + max_fingerprint_size]{};
+		for (auto i = offset; i < haystack.size(); i += 16) {
+			const auto num_left = haystack.size() - i;
+			const auto* block = haystack.data() + i;
+			if (num_left < block_reach) {
+				// Zero padded, candidates reaching beyond the haystack fail verification
+				std::memset(tail, 0, sizeof(tail));
+				std::memcpy(tail, block, num_left);
+				block = tail;
+			}
+			auto buckets = _mm_set1_epi8(static_cast<char>(0xFF));
+			for (size_t k = 0; k < fingerprint_size_; ++k) {
+				const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + k));
+				const auto lo = _mm_and_si128(v, low_nibble_mask);
+				const auto hi = _mm_and_si128(_mm_srli_epi16(v, 4), low_nibble_mask);
+				const auto lo_buckets = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lo_masks_[k].data())), lo);
+				const auto hi_buckets = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hi_masks_[k].data())), hi);
+				buckets = _mm_and_si128(buckets, _mm_and_si128(lo_buckets, hi_buckets));
+			}
+			const auto is_empty = _mm_movemask_epi8(_mm_cmpeq_epi8(buckets, _mm_setzero_si128()));
+			auto candidates = static_cast<uint32_t>(~is_empty & 0xFFFF);
+			if (num_left < 16) {
+				candidates &= (uint32_t{ 1 } << num_left) - 1;
+			}
+			if (candidates == 0) PRECOOKED_LIKELY {
+				continue;
+			}
+			uint8_t bucket_bits[16]{};
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(bucket_bits), buckets);
+			for (; candidates != 0; candidates &= candidates - 1) {
+				const auto j = detail::count_trailing_zeros(candidates);
+				const auto candidate = i + j;
+				for (auto bits = uint32_t{ bucket_bits[j] }; bits != 0; bits &= bits - 1) {
+					for (const auto needle_idx : bucket_needles_[detail::count_trailing_zeros(bits)]) {
+						if (is_match_at(haystack, candidate, needle_idx) && !on_match_f(match_t{ candidate, needle_idx })) {
+							return;
+						}
+					}
+				}
+			}
+		}
+	}
+#endif
 
+	// Aho-Corasick
+	[[nodiscard]] auto transition(const uint32_t state, const char c) const noexcept -> uint32_t {
+		return transitions_[state * num_classes_ + byte_classes_[to_idx(c)]];
+	}
+	auto build_automaton() -> void {
+		// Chars that do not occur in any needle share class 0
+		num_classes_ = 1;
+		for (const auto& needle : needles_) {
+			for (const auto c : needle) {
+				auto& byte_class = byte_classes_[to_idx(fold(c))];
+				if (byte_class == 0) {
+					byte_class = static_cast<uint16_t>(num_classes_++);
+				}
+			}
+		}
+		if constexpr (IgnoreCase) {
+			for (auto c = 'A'; c <= 'Z'; ++c) {
+				byte_classes_[to_idx(c)] = byte_classes_[to_idx(detail::ascii_to_lower(c))];
+			}
+		}
+		// Trie
+		transitions_.assign(num_classes_, no_state);
+		auto state_outputs = std::vector<std::vector<size_t>>(1);
+		auto state_depths = std::vector<size_t>(1, 0);
+		for (size_t idx = 0; idx < needles_.size(); ++idx) {
+			if (needles_[idx].empty()) {
+				continue;
+			}
+			auto state = uint32_t{ 0 };
+			for (const auto c : needles_[idx]) {
+				const auto slot = state * num_classes_ + byte_classes_[to_idx(c)];
+				if (transitions_[slot] == no_state) {
+					transitions_[slot] = static_cast<uint32_t>(state_outputs.size());
+					transitions_.resize(transitions_.size() + num_classes_, no_state);
+					state_outputs.emplace_back();
+				}
+				state = transitions_[slot];
+			}
+			state_outputs[state].push_back(idx);
+		}
+		const auto num_states = state_outputs.size();
+		// Failure links breadth first, completing the transitions into a DFA
+		auto failures = std::vector<uint32_t>(num_states, 0);
+		output_links_.assign(num_states, no_state);
+		auto queue = std::vector<uint32_t>{};
+		queue.reserve(num_states);
+		for (size_t cls = 0; cls < num_classes_; ++cls) {
+			auto& next = transitions_[cls];
+			if (next == no_state) {
+				next = 0;
+			}
+			else {
+				queue.push_back(next);
+			}
+		}
+		for (size_t q = 0; q < queue.size(); ++q) {
+			const auto state = queue[q];
+			const auto failure = failures[state];
+			output_links_[state] = state_outputs[failure].empty() ? output_links_[failure] : failure;
+			for (size_t cls = 0; cls < num_classes_; ++cls) {
+				auto& next = transitions_[state * num_classes_ + cls];
+				const auto failure_next = transitions_[failure * num_classes_ + cls];
+				if (next == no_state) {
+					next = failure_next;
+				}
+				else {
+					failures[next] = failure_next;
+					queue.push_back(next);
+				}
+			}
+		}
+		// Flattened outputs, a match state has own outputs or an output link
+		output_begins_.assign(num_states + 1, 0);
+		for (size_t state = 0; state < num_states; ++state) {
+			output_begins_[state + 1] = output_begins_[state] + static_cast<uint32_t>(state_outputs[state].size());
+			outputs_.insert(outputs_.end(), state_outputs[state].begin(), state_outputs[state].end());
+		}
+		is_match_state_.assign(num_states, 0);
+		for (size_t state = 0; state < num_states; ++state) {
+			is_match_state_[state] = !state_outputs[state].empty() || output_links_[state] != no_state;
+		}
+	}
+	// Invokes on_match_f(match_t) by increasing match end, until it returns false
+	template <typename OnMatchF>
+	auto automaton_for_each(
+		const std::string_view haystack,
+		const size_t offset,
+		const OnMatchF& on_match_f
+	) const -> void {
+		auto state = uint32_t{ 0 };
+		for (auto i = offset; i < haystack.size(); ++i) {
+			state = transition(state, haystack[i]);
+			if (!is_match_state_[state]) PRECOOKED_LIKELY {
+				continue;
+			}
+			for (auto s = state; s != no_state; s = output_links_[s]) {
+				for (auto o = output_begins_[s]; o != output_begins_[s + 1]; ++o) {
+					const auto needle_idx = outputs_[o];
+					const auto match_offset = i + 1 - needles_[needle_idx].size();
+					if (!on_match_f(match_t{ match_offset, needle_idx })) {
+						return;
+					}
+				}
+			}
+		}
+	}
+	[[nodiscard]] auto automaton_find_first(
+		const std::string_view haystack,
+		const size_t offset
+	) const noexcept -> std::optional<match_t> {
+		// Matches are found by their end, the scan stops once no later 
+		// match can start at or before the best one
+		auto best = std::optional<match_t>{};
+		auto state = uint32_t{ 0 };
+		for (auto i = offset; i < haystack.size(); ++i) {
+			if (best.has_value() && i + 1 > best->offset + max_needle_size_) {
+				break;
+			}
+			state = transition(state, haystack[i]);
+			if (!is_match_state_[state]) PRECOOKED_LIKELY {
+				continue;
+			}
+			for (auto s = state; s != no_state; s = output_links_[s]) {
+				for (auto o = output_begins_[s]; o != output_begins_[s + 1]; ++o) {
+					const auto match = match_t{ i + 1 - needles_[outputs_[o]].size(), outputs_[o] };
+					const auto is_better = 
+						!best.has_value() ||
+						match.offset < best->offset ||
+						(match.offset == best->offset && match.needle_idx < best->needle_idx);
+					if (is_better) {
+						best = match;
+					}
+				}
+			}
+		}
+		return best;
+	}
 
+	std::vector<std::string> needles_{};
+	size_t min_needle_size_{ 0 };
+	size_t max_needle_size_{ 0 };
+	// Teddy
+	bool is_teddy_{ false };
+	size_t fingerprint_size_{ 0 };
+	std::array<std::array<uint8_t, 16>, max_fingerprint_size> lo_masks_{};
+	std::array<std::array<uint8_t, 16>, max_fingerprint_size> hi_masks_{};
+	std::array<std::vector<size_t>, num_teddy_buckets> bucket_needles_{};
+	// Aho-Corasick
+	std::array<uint16_t, 256> byte_classes_{};
+	size_t num_classes_{ 0 };
+	std::vector<uint32_t> transitions_{};
+	std::vector<uint32_t> output_links_{};
+	std::vector<uint32_t> output_begins_{};
+	std::vector<size_t> outputs_{};
+	std::vector<uint8_t> is_match_state_{};
+};
 
 
 //////////////////////////////////////////////////////////////////////////////
@@ -1568,30 +4862,138 @@ auto peo::replace_all_ignore_case(
 
 #include <algorithm>
 
+namespace peo::detail {
+// Folds ASCII letters a block at a time. Unless the non-ASCII chars are 
+// folded like the classic locale, blocks containing them are folded by char.
+template <bool ToUpper, bool IsClassic, typename FoldCharF>
+auto impl_fold_ascii(
+	const char* src,
+	const size_t size,
+	char* dst,
+	const FoldCharF& fold_char_f
+) -> void {
+	size_t i = 0;
+	const auto fold_chars_f = [&](const size_t end) {
+		for (; i < end; ++i) {
+			dst[i] = fold_char_f(src[i]);
+		}
+	};
+#if PRECOOKED_AVX2
+	for (; i + 32 <= size;) {
+		const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+		if (!IsClassic && _mm256_movemask_epi8(v) != 0) {
+			fold_chars_f(i + 32);
+			continue;
+		}
+		const auto folded = ToUpper ? ascii_to_upper_avx2(v) : ascii_to_lower_avx2(v);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), folded);
+		i += 32;
+	}
+#endif
+#if PRECOOKED_SSE2
+	for (; i + 16 <= size;) {
+		const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		if (!IsClassic && _mm_movemask_epi8(v) != 0) {
+			fold_chars_f(i + 16);
+			continue;
+		}
+		const auto folded = ToUpper ? ascii_to_upper_sse2(v) : ascii_to_lower_sse2(v);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), folded);
+		i += 16;
+	}
+#endif
+	fold_chars_f(size);
+}
+
+template <bool ToUpper, typename Char, typename Folder>
+auto impl_fold_case(
+	const std::basic_string_view<Char>& src,
+	Char* dst,
+	const Folder& folder
+) -> void {
+	const auto fold_char_f = [&folder](const Char& c) {
+		if constexpr (ToUpper) { return folder.to_upper(c); }
+		else { return folder.to_lower(c); }
+	};
+	if constexpr (std::is_same_v<Char, char>) {
+		if (folder.is_classic()) {
+			const auto fold_ascii_char_f = [](const char c) noexcept {
+				return ToUpper ? ascii_to_upper(c) : ascii_to_lower(c);
+			};
+			impl_fold_ascii<ToUpper, true>(src.data(), src.size(), dst, fold_ascii_char_f);
+			return;
+		}
+		if (folder.is_ascii_compatible()) {
+			impl_fold_ascii<ToUpper, false>(src.data(), src.size(), dst, fold_char_f);
+			return;
+		}
+	}
+	std::transform(src.begin(), src.end(), dst, fold_char_f);
+}
+
+template <typename Char, typename Folder>
+auto impl_to_lower(
+	const std::basic_string_view<Char>& src,
+	Char* dst,
+	const Folder& folder
+) -> void {
+	impl_fold_case<false>(src, dst, folder);
+}
+
+template <typename Char, typename Folder>
+auto impl_to_upper(
+	const std::basic_string_view<Char>& src,
+	Char* dst,
+	const Folder& folder
+) -> void {
+	impl_fold_case<true>(src, dst, folder);
+}
+}
+
+
+template <typename Char>
+auto peo::to_lower(
+	std::basic_string<Char> str, 
+	const std::locale& loc
+) noexcept -> std::basic_string<Char> {
+	detail::impl_to_lower(std::basic_string_view<Char>{ str }, str.data(), detail::locale_folder{ loc });
+	return str;
+}
+
 template <typename Char>
 auto peo::to_lower(
-	std::basic_string<Char> str, 
+	std::basic_string<Char> str, 
+	const case_folder& folder
+) noexcept -> std::basic_string<Char> {
+	detail::impl_to_lower(std::basic_string_view<Char>{ str }, str.data(), folder);
+	return str;
+}
+
+template <typename StrView> 
+auto peo::to_lower(
+	const StrView& strview, 
 	const std::locale& loc
-) noexcept -> std::basic_string<Char> {
-	std::transform(str.begin(), str.end(), str.begin(), [&loc](const Char& c) {
-		return std::tolower(c, loc);
-	});
+) -> std::basic_string<type_traits::underlying_char_t<StrView>> {
+	using Char = type_traits::underlying_char_t<StrView>;
+	static_assert(type_traits::is_valid_char_v<Char>);
+	const auto sv = std::basic_string_view<Char>{strview};
+	auto str = std::basic_string<Char>{};
+	str.resize(sv.size());
+	detail::impl_to_lower(sv, str.data(), detail::locale_folder{ loc });
 	return str;
 }
 
 template <typename StrView> 
 auto peo::to_lower(
 	const StrView& strview, 
-	const std::locale& loc
+	const case_folder& folder
 ) -> std::basic_string<type_traits::underlying_char_t<StrView>> {
 	using Char = type_traits::underlying_char_t<StrView>;
 	static_assert(type_traits::is_valid_char_v<Char>);
 	const auto sv = std::basic_string_view<Char>{strview};
 	auto str = std::basic_string<Char>{};
 	str.resize(sv.size());
-	std::transform(sv.begin(), sv.end(), str.begin(), [&loc](const Char& c) {
-		return std::tolower(c, loc);
-	});
+	detail::impl_to_lower(sv, str.data(), folder);
 	return str;
 }
 
@@ -1601,9 +5003,16 @@ auto peo::to_upper(
 	std::basic_string<Char> str,
 	const std::locale& loc
 ) noexcept -> std::basic_string<Char> {
-	std::transform(str.begin(), str.end(), str.begin(), [&loc](const Char& c) {
-		return std::toupper(c, loc);
-	});
+	detail::impl_to_upper(std::basic_string_view<Char>{ str }, str.data(), detail::locale_folder{ loc });
+	return str;
+}
+
+template <typename Char>
+auto peo::to_upper(
+	std::basic_string<Char> str,
+	const case_folder& folder
+) noexcept -> std::basic_string<Char> {
+	detail::impl_to_upper(std::basic_string_view<Char>{ str }, str.data(), folder);
 	return str;
 }
 
@@ -1617,14 +5026,21 @@ auto peo::to_upper(
 	const auto sv = std::basic_string_view<Char>{ strview };
 	auto str = std::basic_string<Char>{};
 	str.resize(sv.size());
-	std::transform(
-		sv.begin(), 
-		sv.end(), 
-		str.begin(), 
-		[&loc](const Char& c) {
-			return std::toupper(c, loc);
-		}
-	);
+	detail::impl_to_upper(sv, str.data(), detail::locale_folder{ loc });
+	return str;
+}
+
+template <typename StrView>
+auto peo::to_upper(
+	const StrView& strview, 
+	const case_folder& folder
+) -> std::basic_string<type_traits::underlying_char_t<StrView>> {
+	using Char = type_traits::underlying_char_t<StrView>;
+	static_assert(type_traits::is_valid_char_v<Char>);
+	const auto sv = std::basic_string_view<Char>{ strview };
+	auto str = std::basic_string<Char>{};
+	str.resize(sv.size());
+	detail::impl_to_upper(sv, str.data(), folder);
 	return str;
 }
 
@@ -1634,11 +5050,28 @@ auto peo::is_equal_ignore_case(
 	const Str1& b, 
 	const std::locale& loc
 ) noexcept -> bool {
-	const auto a_sv = std::basic_string_view{ a };
-	const auto b_sv = std::basic_string_view{ b };
+	using Char = type_traits::underlying_char_t<Str0>;
+	static_assert(type_traits::is_valid_char_v<Char>);
+	const auto a_sv = std::basic_string_view<Char>{ a };
+	const auto b_sv = std::basic_string_view<Char>{ b };
+	return
+		a_sv.size() == b_sv.size() &&
+		detail::impl_is_equal_ignore_case(a_sv, b_sv, detail::locale_folder{ loc });
+}
+
+template <typename Str0, typename Str1>
+auto peo::is_equal_ignore_case(
+	const Str0& a, 
+	const Str1& b, 
+	const case_folder& folder
+) noexcept -> bool {
+	using Char = type_traits::underlying_char_t<Str0>;
+	static_assert(type_traits::is_valid_char_v<Char>);
+	const auto a_sv = std::basic_string_view<Char>{ a };
+	const auto b_sv = std::basic_string_view<Char>{ b };
 	return
 		a_sv.size() == b_sv.size() &&
-		detail::impl_is_equal_ignore_case(a_sv, b_sv, loc);
+		detail::impl_is_equal_ignore_case(a_sv, b_sv, folder);
 }
 
 template <typename Str0, typename Str1>
@@ -1661,45 +5094,792 @@ auto peo::contains_substring_ignore_case(
 	return find_ignore_case(haystack, needle, 0, loc) != std::string::npos;
 }
 
+template <typename Str0, typename Str1>
+auto peo::contains_substring_ignore_case(
+	const Str0& haystack, 
+	const Str1& needle, 
+	const case_folder& folder
+) noexcept -> bool {
+	return find_ignore_case(haystack, needle, 0, folder) != std::string::npos;
+}
+
+
+namespace peo::detail {
+template <typename Char, typename Folder>
+[[nodiscard]] auto impl_find_ignore_case_checked(
+	const std::basic_string_view<Char>& haystack,
+	const std::basic_string_view<Char>& needle,
+	const size_t offset,
+	const Folder& folder
+) noexcept -> size_t {
+	const auto cannot_possibly_exist =
+		haystack.size() < needle.size() || 
+		needle.empty();
+	if (cannot_possibly_exist) {
+		return std::string::npos;
+	}
+	return impl_find_ignore_case(haystack, needle, offset, folder);
+}
+}
+
+template <typename Str0, typename Str1>
+auto peo::find_ignore_case(
+	const Str0& haystack,
+	const Str1& needle,
+	const size_t offset,
+	const std::locale& loc
+) noexcept -> size_t {
+	using Char = type_traits::underlying_char_t<Str0>;
+	static_assert(type_traits::is_valid_char_v<Char>);
+	return detail::impl_find_ignore_case_checked(
+		std::basic_string_view<Char>{ haystack },
+		std::basic_string_view<Char>{ needle },
+		offset,
+		detail::locale_folder{ loc }
+	);
+}
+
+template <typename Str0, typename Str1>
+auto peo::find_ignore_case(
+	const Str0& haystack,
+	const Str1& needle,
+	const size_t offset,
+	const case_folder& folder
+) noexcept -> size_t {
+	using Char = type_traits::underlying_char_t<Str0>;
+	static_assert(type_traits::is_valid_char_v<Char>);
+	return detail::impl_find_ignore_case_checked(
+		std::basic_string_view<Char>{ haystack },
+		std::basic_string_view<Char>{ needle },
+		offset,
+		folder
+	);
+}
+
+template <typename Str0, typename Str1>
+auto peo::find_ignore_case(
+	const Str0& haystack,
+	const Str1& needle,
+	const std::locale& loc
+) noexcept -> size_t {
+	return find_ignore_case(
+		haystack,
+		needle,
+		size_t{ 0 },
+		loc
+	);
+}
+
+template <typename Str0, typename Str1>
+auto peo::find_ignore_case(
+	const Str0& haystack,
+	const Str1& needle,
+	const case_folder& folder
+) noexcept -> size_t {
+	return find_ignore_case(
+		haystack,
+		needle,
+		size_t{ 0 },
+		folder
+	);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+
+#include <cstring>
+
+namespace peo::detail {
+
+// Code points [first, last] with a multiple of stride from first are mapped to code point + delta
+struct utf8_case_range_t {
+	char32_t first{};
+	char32_t last{};
+	int32_t delta{};
+	uint32_t stride{};
+};
+
+// Simple case mappings of non-ASCII code points, generated from Unicode 14.0.0
+// UnicodeData.txt and CaseFolding.txt (statuses C and S). Sorted by first.
+inline constexpr utf8_case_range_t utf8_lower_ranges[] = {
+	{ 0x00C0, 0x00D6, 32, 1 }, { 0x00D8, 0x00DE, 32, 1 }, { 0x0100, 0x012E, 1, 2 }, { 0x0130, 0x0130, -199, 1 },
+	{ 0x0132, 0x0136, 1, 2 }, { 0x0139, 0x0147, 1, 2 }, { 0x014A, 0x0176, 1, 2 }, { 0x0178, 0x0178, -121, 1 },
+	{ 0x0179, 0x017D, 1, 2 }, { 0x0181, 0x0181, 210, 1 }, { 0x0182, 0x0184, 1, 2 }, { 0x0186, 0x0186, 206, 1 },
+	{ 0x0187, 0x0187, 1, 1 }, { 0x0189, 0x018A, 205, 1 }, { 0x018B, 0x018B, 1, 1 }, { 0x018E, 0x018E, 79, 1 },
+	{ 0x018F, 0x018F, 202, 1 }, { 0x0190, 0x0190, 203, 1 }, { 0x0191, 0x0191, 1, 1 }, { 0x0193, 0x0193, 205, 1 },
+	{ 0x0194, 0x0194, 207, 1 }, { 0x0196, 0x0196, 211, 1 }, { 0x0197, 0x0197, 209, 1 }, { 0x0198, 0x0198, 1, 1 },
+	{ 0x019C, 0x019C, 211, 1 }, { 0x019D, 0x019D, 213, 1 }, { 0x019F, 0x019F, 214, 1 }, { 0x01A0, 0x01A4, 1, 2 },
+	{ 0x01A6, 0x01A6, 218, 1 }, { 0x01A7, 0x01A7, 1, 1 }, { 0x01A9, 0x01A9, 218, 1 }, { 0x01AC, 0x01AC, 1, 1 },
+	{ 0x01AE, 0x01AE, 218, 1 }, { 0x01AF, 0x01AF, 1, 1 }, { 0x01B1, 0x01B2, 217, 1 }, { 0x01B3, 0x01B5, 1, 2 },
+	{ 0x01B7, 0x01B7, 219, 1 }, { 0x01B8, 0x01B8, 1, 1 }, { 0x01BC, 0x01BC, 1, 1 }, { 0x01C4, 0x01C4, 2, 1 },
+	{ 0x01C5, 0x01C5, 1, 1 }, { 0x01C7, 0x01C7, 2, 1 }, { 0x01C8, 0x01C8, 1, 1 }, { 0x01CA, 0x01CA, 2, 1 },
+	{ 0x01CB, 0x01DB, 1, 2 }, { 0x01DE, 0x01EE, 1, 2 }, { 0x01F1, 0x01F1, 2, 1 }, { 0x01F2, 0x01F4, 1, 2 },
+	{ 0x01F6, 0x01F6, -97, 1 }, { 0x01F7, 0x01F7, -56, 1 }, { 0x01F8, 0x021E, 1, 2 }, { 0x0220, 0x0220, -130, 1 },
+	{ 0x0222, 0x0232, 1, 2 }, { 0x023A, 0x023A, 10795, 1 }, { 0x023B, 0x023B, 1, 1 }, { 0x023D, 0x023D, -163, 1 },
+	{ 0x023E, 0x023E, 10792, 1 }, { 0x0241, 0x0241, 1, 1 }, { 0x0243, 0x0243, -195, 1 }, { 0x0244, 0x0244, 69, 1 },
+	{ 0x0245, 0x0245, 71, 1 }, { 0x0246, 0x024E, 1, 2 }, { 0x0370, 0x0372, 1, 2 }, { 0x0376, 0x0376, 1, 1 },
+	{ 0x037F, 0x037F, 116, 1 }, { 0x0386, 0x0386, 38, 1 }, { 0x0388, 0x038A, 37, 1 }, { 0x038C, 0x038C, 64, 1 },
+	{ 0x038E, 0x038F, 63, 1 }, { 0x0391, 0x03A1, 32, 1 }, { 0x03A3, 0x03AB, 32, 1 }, { 0x03CF, 0x03CF, 8, 1 },
+	{ 0x03D8, 0x03EE, 1, 2 }, { 0x03F4, 0x03F4, -60, 1 }, { 0x03F7, 0x03F7, 1, 1 }, { 0x03F9, 0x03F9, -7, 1 },
+	{ 0x03FA, 0x03FA, 1, 1 }, { 0x03FD, 0x03FF, -130, 1 }, { 0x0400, 0x040F, 80, 1 }, { 0x0410, 0x042F, 32, 1 },
+	{ 0x0460, 0x0480, 1, 2 }, { 0x048A, 0x04BE, 1, 2 }, { 0x04C0, 0x04C0, 15, 1 }, { 0x04C1, 0x04CD, 1, 2 },
+	{ 0x04D0, 0x052E, 1, 2 }, { 0x0531, 0x0556, 48, 1 }, { 0x10A0, 0x10C5, 7264, 1 }, { 0x10C7, 0x10C7, 7264, 1 },
+	{ 0x10CD, 0x10CD, 7264, 1 }, { 0x13A0, 0x13EF, 38864, 1 }, { 0x13F0, 0x13F5, 8, 1 }, { 0x1C90, 0x1CBA, -3008, 1 },
+	{ 0x1CBD, 0x1CBF, -3008, 1 }, { 0x1E00, 0x1E94, 1, 2 }, { 0x1E9E, 0x1E9E, -7615, 1 }, { 0x1EA0, 0x1EFE, 1, 2 },
+	{ 0x1F08, 0x1F0F, -8, 1 }, { 0x1F18, 0x1F1D, -8, 1 }, { 0x1F28, 0x1F2F, -8, 1 }, { 0x1F38, 0x1F3F, -8, 1 },
+	{ 0x1F48, 0x1F4D, -8, 1 }, { 0x1F59, 0x1F5F, -8, 2 }, { 0x1F68, 0x1F6F, -8, 1 }, { 0x1F88, 0x1F8F, -8, 1 },
+	{ 0x1F98, 0x1F9F, -8, 1 }, { 0x1FA8, 0x1FAF, -8, 1 }, { 0x1FB8, 0x1FB9, -8, 1 }, { 0x1FBA, 0x1FBB, -74, 1 },
+	{ 0x1FBC, 0x1FBC, -9, 1 }, { 0x1FC8, 0x1FCB, -86, 1 }, { 0x1FCC, 0x1FCC, -9, 1 }, { 0x1FD8, 0x1FD9, -8, 1 },
+	{ 0x1FDA, 0x1FDB, -100, 1 }, { 0x1FE8, 0x1FE9, -8, 1 }, { 0x1FEA, 0x1FEB, -112, 1 }, { 0x1FEC, 0x1FEC, -7, 1 },
+	{ 0x1FF8, 0x1FF9, -128, 1 }, { 0x1FFA, 0x1FFB, -126, 1 }, { 0x1FFC, 0x1FFC, -9, 1 }, { 0x2126, 0x2126, -7517, 1 },
+	{ 0x212A, 0x212A, -8383, 1 }, { 0x212B, 0x212B, -8262, 1 }, { 0x2132, 0x2132, 28, 1 }, { 0x2160, 0x216F, 16, 1 },
+	{ 0x2183, 0x2183, 1, 1 }, { 0x24B6, 0x24CF, 26, 1 }, { 0x2C00, 0x2C2F, 48, 1 }, { 0x2C60, 0x2C60, 1, 1 },
+	{ 0x2C62, 0x2C62, -10743, 1 }, { 0x2C63, 0x2C63, -3814, 1 }, { 0x2C64, 0x2C64, -10727, 1 }, { 0x2C67, 0x2C6B, 1, 2 },
+	{ 0x2C6D, 0x2C6D, -10780, 1 }, { 0x2C6E, 0x2C6E, -10749, 1 }, { 0x2C6F, 0x2C6F, -10783, 1 }, { 0x2C70, 0x2C70, -10782, 1 },
+	{ 0x2C72, 0x2C72, 1, 1 }, { 0x2C75, 0x2C75, 1, 1 }, { 0x2C7E, 0x2C7F, -10815, 1 }, { 0x2C80, 0x2CE2, 1, 2 },
+	{ 0x2CEB, 0x2CED, 1, 2 }, { 0x2CF2, 0x2CF2, 1, 1 }, { 0xA640, 0xA66C, 1, 2 }, { 0xA680, 0xA69A, 1, 2 },
+	{ 0xA722, 0xA72E, 1, 2 }, { 0xA732, 0xA76E, 1, 2 }, { 0xA779, 0xA77B, 1, 2 }, { 0xA77D, 0xA77D, -35332, 1 },
+	{ 0xA77E, 0xA786, 1, 2 }, { 0xA78B, 0xA78B, 1, 1 }, { 0xA78D, 0xA78D, -42280, 1 }, { 0xA790, 0xA792, 1, 2 },
+	{ 0xA796, 0xA7A8, 1, 2 }, { 0xA7AA, 0xA7AA, -42308, 1 }, { 0xA7AB, 0xA7AB, -42319, 1 }, { 0xA7AC, 0xA7AC, -42315, 1 },
+	{ 0xA7AD, 0xA7AD, -42305, 1 }, { 0xA7AE, 0xA7AE, -42308, 1 }, { 0xA7B0, 0xA7B0, -42258, 1 }, { 0xA7B1, 0xA7B1, -42282, 1 },
+	{ 0xA7B2, 0xA7B2, -42261, 1 }, { 0xA7B3, 0xA7B3, 928, 1 }, { 0xA7B4, 0xA7C2, 1, 2 }, { 0xA7C4, 0xA7C4, -48, 1 },
+	{ 0xA7C5, 0xA7C5, -42307, 1 }, { 0xA7C6, 0xA7C6, -35384, 1 }, { 0xA7C7, 0xA7C9, 1, 2 }, { 0xA7D0, 0xA7D0, 1, 1 },
+	{ 0xA7D6, 0xA7D8, 1, 2 }, { 0xA7F5, 0xA7F5, 1, 1 }, { 0xFF21, 0xFF3A, 32, 1 }, { 0x10400, 0x10427, 40, 1 },
+	{ 0x104B0, 0x104D3, 40, 1 }, { 0x10570, 0x1057A, 39, 1 }, { 0x1057C, 0x1058A, 39, 1 }, { 0x1058C, 0x10592, 39, 1 },
+	{ 0x10594, 0x10595, 39, 1 }, { 0x10C80, 0x10CB2, 64, 1 }, { 0x118A0, 0x118BF, 32, 1 }, { 0x16E40, 0x16E5F, 32, 1 },
+	{ 0x1E900, 0x1E921, 34, 1 },
+};
+inline constexpr utf8_case_range_t utf8_fold_ranges[] = {
+	{ 0x00B5, 0x00B5, 775, 1 }, { 0x00C0, 0x00D6, 32, 1 }, { 0x00D8, 0x00DE, 32, 1 }, { 0x0100, 0x012E, 1, 2 },
+	{ 0x0132, 0x0136, 1, 2 }, { 0x0139, 0x0147, 1, 2 }, { 0x014A, 0x0176, 1, 2 }, { 0x0178, 0x0178, -121, 1 },
+	{ 0x0179, 0x017D, 1, 2 }, { 0x017F, 0x017F, -268, 1 }, { 0x0181, 0x0181, 210, 1 }, { 0x0182, 0x0184, 1, 2 },
+	{ 0x0186, 0x0186, 206, 1 }, { 0x0187, 0x0187, 1, 1 }, { 0x0189, 0x018A, 205, 1 }, { 0x018B, 0x018B, 1, 1 },
+	{ 0x018E, 0x018E, 79, 1 }, { 0x018F, 0x018F, 202, 1 }, { 0x0190, 0x0190, 203, 1 }, { 0x0191, 0x0191, 1, 1 },
+	{ 0x0193, 0x0193, 205, 1 }, { 0x0194, 0x0194, 207, 1 }, { 0x0196, 0x0196, 211, 1 }, { 0x0197, 0x0197, 209, 1 },
+	{ 0x0198, 0x0198, 1, 1 }, { 0x019C, 0x019C, 211, 1 }, { 0x019D, 0x019D, 213, 1 }, { 0x019F, 0x019F, 214, 1 },
+	{ 0x01A0, 0x01A4, 1, 2 }, { 0x01A6, 0x01A6, 218, 1 }, { 0x01A7, 0x01A7, 1, 1 }, { 0x01A9, 0x01A9, 218, 1 },
+	{ 0x01AC, 0x01AC, 1, 1 }, { 0x01AE, 0x01AE, 218, 1 }, { 0x01AF, 0x01AF, 1, 1 }, { 0x01B1, 0x01B2, 217, 1 },
+	{ 0x01B3, 0x01B5, 1, 2 }, { 0x01B7, 0x01B7, 219, 1 }, { 0x01B8, 0x01B8, 1, 1 }, { 0x01BC, 0x01BC, 1, 1 },
+	{ 0x01C4, 0x01C4, 2, 1 }, { 0x01C5, 0x01C5, 1, 1 }, { 0x01C7, 0x01C7, 2, 1 }, { 0x01C8, 0x01C8, 1, 1 },
+	{ 0x01CA, 0x01CA, 2, 1 }, { 0x01CB, 0x01DB, 1, 2 }, { 0x01DE, 0x01EE, 1, 2 }, { 0x01F1, 0x01F1, 2, 1 },
+	{ 0x01F2, 0x01F4, 1, 2 }, { 0x01F6, 0x01F6, -97, 1 }, { 0x01F7, 0x01F7, -56, 1 }, { 0x01F8, 0x021E, 1, 2 },
+	{ 0x0220, 0x0220, -130, 1 }, { 0x0222, 0x0232, 1, 2 }, { 0x023A, 0x023A, 10795, 1 }, { 0x023B, 0x023B, 1, 1 },
+	{ 0x023D, 0x023D, -163, 1 }, { 0x023E, 0x023E, 10792, 1 }, { 0x0241, 0x0241, 1, 1 }, { 0x0243, 0x0243, -195, 1 },
+	{ 0x0244, 0x0244, 69, 1 }, { 0x0245, 0x0245, 71, 1 }, { 0x0246, 0x024E, 1, 2 }, { 0x0345, 0x0345, 116, 1 },
+	{ 0x0370, 0x0372, 1, 2 }, { 0x0376, 0x0376, 1, 1 }, { 0x037F, 0x037F, 116, 1 }, { 0x0386, 0x0386, 38, 1 },
+	{ 0x0388, 0x038A, 37, 1 }, { 0x038C, 0x038C, 64, 1 }, { 0x038E, 0x038F, 63, 1 }, { 0x0391, 0x03A1, 32, 1 },
+	{ 0x03A3, 0x03AB, 32, 1 }, { 0x03C2, 0x03C2, 1, 1 }, { 0x03CF, 0x03CF, 8, 1 }, { 0x03D0, 0x03D0, -30, 1 },
+	{ 0x03D1, 0x03D1, -25, 1 }, { 0x03D5, 0x03D5, -15, 1 }, { 0x03D6, 0x03D6, -22, 1 }, { 0x03D8, 0x03EE, 1, 2 },
+	{ 0x03F0, 0x03F0, -54, 1 }, { 0x03F1, 0x03F1, -48, 1 }, { 0x03F4, 0x03F4, -60, 1 }, { 0x03F5, 0x03F5, -64, 1 },
+	{ 0x03F7, 0x03F7, 1, 1 }, { 0x03F9, 0x03F9, -7, 1 }, { 0x03FA, 0x03FA, 1, 1 }, { 0x03FD, 0x03FF, -130, 1 },
+	{ 0x0400, 0x040F, 80, 1 }, { 0x0410, 0x042F, 32, 1 }, { 0x0460, 0x0480, 1, 2 }, { 0x048A, 0x04BE, 1, 2 },
+	{ 0x04C0, 0x04C0, 15, 1 }, { 0x04C1, 0x04CD, 1, 2 }, { 0x04D0, 0x052E, 1, 2 }, { 0x0531, 0x0556, 48, 1 },
+	{ 0x10A0, 0x10C5, 7264, 1 }, { 0x10C7, 0x10C7, 7264, 1 }, { 0x10CD, 0x10CD, 7264, 1 }, { 0x13F8, 0x13FD, -8, 1 },
+	{ 0x1C80, 0x1C80, -6222, 1 }, { 0x1C81, 0x1C81, -6221, 1 }, { 0x1C82, 0x1C82, -6212, 1 }, { 0x1C83, 0x1C84, -6210, 1 },
+	{ 0x1C85, 0x1C85, -6211, 1 }, { 0x1C86, 0x1C86, -6204, 1 }, { 0x1C87, 0x1C87, -6180, 1 }, { 0x1C88, 0x1C88, 35267, 1 },
+	{ 0x1C90, 0x1CBA, -3008, 1 }, { 0x1CBD, 0x1CBF, -3008, 1 }, { 0x1E00, 0x1E94, 1, 2 }, { 0x1E9B, 0x1E9B, -58, 1 },
+	{ 0x1E9E, 0x1E9E, -7615, 1 }, { 0x1EA0, 0x1EFE, 1, 2 }, { 0x1F08, 0x1F0F, -8, 1 }, { 0x1F18, 0x1F1D, -8, 1 },
+	{ 0x1F28, 0x1F2F, -8, 1 }, { 0x1F38, 0x1F3F, -8, 1 }, { 0x1F48, 0x1F4D, -8, 1 }, { 0x1F59, 0x1F5F, -8, 2 },
+	{ 0x1F68, 0x1F6F, -8, 1 }, { 0x1F88, 0x1F8F, -8, 1 }, { 0x1F98, 0x1F9F, -8, 1 }, { 0x1FA8, 0x1FAF, -8, 1 },
+	{ 0x1FB8, 0x1FB9, -8, 1 }, { 0x1FBA, 0x1FBB, -74, 1 }, { 0x1FBC, 0x1FBC, -9, 1 }, { 0x1FBE, 0x1FBE, -7173, 1 },
+	{ 0x1FC8, 0x1FCB, -86, 1 }, { 0x1FCC, 0x1FCC, -9, 1 }, { 0x1FD8, 0x1FD9, -8, 1 }, { 0x1FDA, 0x1FDB, -100, 1 },
+	{ 0x1FE8, 0x1FE9, -8, 1 }, { 0x1FEA, 0x1FEB, -112, 1 }, { 0x1FEC, 0x1FEC, -7, 1 }, { 0x1FF8, 0x1FF9, -128, 1 },
+	{ 0x1FFA, 0x1FFB, -126, 1 }, { 0x1FFC, 0x1FFC, -9, 1 }, { 0x2126, 0x2126, -7517, 1 }, { 0x212A, 0x212A, -8383, 1 },
+	{ 0x212B, 0x212B, -8262, 1 }, { 0x2132, 0x2132, 28, 1 }, { 0x2160, 0x216F, 16, 1 }, { 0x2183, 0x2183, 1, 1 },
+	{ 0x24B6, 0x24CF, 26, 1 }, { 0x2C00, 0x2C2F, 48, 1 }, { 0x2C60, 0x2C60, 1, 1 }, { 0x2C62, 0x2C62, -10743, 1 },
+	{ 0x2C63, 0x2C63, -3814, 1 }, { 0x2C64, 0x2C64, -10727, 1 }, { 0x2C67, 0x2C6B, 1, 2 }, { 0x2C6D, 0x2C6D, -10780, 1 },
+	{ 0x2C6E, 0x2C6E, -10749, 1 }, { 0x2C6F, 0x2C6F, -10783, 1 }, { 0x2C70, 0x2C70, -10782, 1 }, { 0x2C72, 0x2C72, 1, 1 },
+	{ 0x2C75, 0x2C75, 1, 1 }, { 0x2C7E, 0x2C7F, -10815, 1 }, { 0x2C80, 0x2CE2, 1, 2 }, { 0x2CEB, 0x2CED, 1, 2 },
+	{ 0x2CF2, 0x2CF2, 1, 1 }, { 0xA640, 0xA66C, 1, 2 }, { 0xA680, 0xA69A, 1, 2 }, { 0xA722, 0xA72E, 1, 2 },
+	{ 0xA732, 0xA76E, 1, 2 }, { 0xA779, 0xA77B, 1, 2 }, { 0xA77D, 0xA77D, -35332, 1 }, { 0xA77E, 0xA786, 1, 2 },
+	{ 0xA78B, 0xA78B, 1, 1 }, { 0xA78D, 0xA78D, -42280, 1 }, { 0xA790, 0xA792, 1, 2 }, { 0xA796, 0xA7A8, 1, 2 },
+	{ 0xA7AA, 0xA7AA, -42308, 1 }, { 0xA7AB, 0xA7AB, -42319, 1 }, { 0xA7AC, 0xA7AC, -42315, 1 }, { 0xA7AD, 0xA7AD, -42305, 1 },
+	{ 0xA7AE, 0xA7AE, -42308, 1 }, { 0xA7B0, 0xA7B0, -42258, 1 }, { 0xA7B1, 0xA7B1, -42282, 1 }, { 0xA7B2, 0xA7B2, -42261, 1 },
+	{ 0xA7B3, 0xA7B3, 928, 1 }, { 0xA7B4, 0xA7C2, 1, 2 }, { 0xA7C4, 0xA7C4, -48, 1 }, { 0xA7C5, 0xA7C5, -42307, 1 },
+	{ 0xA7C6, 0xA7C6, -35384, 1 }, { 0xA7C7, 0xA7C9, 1, 2 }, { 0xA7D0, 0xA7D0, 1, 1 }, { 0xA7D6, 0xA7D8, 1, 2 },
+	{ 0xA7F5, 0xA7F5, 1, 1 }, { 0xAB70, 0xABBF, -38864, 1 }, { 0xFF21, 0xFF3A, 32, 1 }, { 0x10400, 0x10427, 40, 1 },
+	{ 0x104B0, 0x104D3, 40, 1 }, { 0x10570, 0x1057A, 39, 1 }, { 0x1057C, 0x1058A, 39, 1 }, { 0x1058C, 0x10592, 39, 1 },
+	{ 0x10594, 0x10595, 39, 1 }, { 0x10C80, 0x10CB2, 64, 1 }, { 0x118A0, 0x118BF, 32, 1 }, { 0x16E40, 0x16E5F, 32, 1 },
+	{ 0x1E900, 0x1E921, 34, 1 },
+};
+
+template <size_t N>
+[[nodiscard]] constexpr auto utf8_map_case(
+	const utf8_case_range_t (&ranges)[N], 
+	const char32_t cp
+) noexcept -> char32_t {
+	// Find the last range starting at or before the code point
+	auto lo = size_t{ 0 };
+	auto hi = N;
+	while (lo < hi) {
+		const auto mid = (lo + hi) / 2;
+		if (ranges[mid].first <= cp) { lo = mid + 1; }
+		else { hi = mid; }
+	}
+	if (lo == 0) {
+		return cp;
+	}
+	const auto& range = ranges[lo - 1];
+	const auto is_mapped = cp <= range.last && (cp - range.first) % range.stride == 0;
+	return is_mapped ?
+		static_cast<char32_t>(static_cast<int32_t>(cp) + range.delta) :
+		cp;
+}
+
+[[nodiscard]] constexpr auto utf8_to_lower(const char32_t cp) noexcept -> char32_t {
+	return cp < 0x80 ?
+		static_cast<char32_t>(ascii_to_lower(static_cast<char>(cp))) :
+		utf8_map_case(utf8_lower_ranges, cp);
+}
+
+[[nodiscard]] constexpr auto utf8_fold_case(const char32_t cp) noexcept -> char32_t {
+	return cp < 0x80 ?
+		static_cast<char32_t>(ascii_to_lower(static_cast<char>(cp))) :
+		utf8_map_case(utf8_fold_ranges, cp);
+}
+
+// Invalid bytes decode to lone surrogates, which valid UTF-8 cannot contain, 
+// hence they are kept as is and only compare equal to the same byte
+constexpr auto utf8_invalid_byte_base = char32_t{ 0xDC00 };
+
+// Decodes the code point at it, returns the number of bytes consumed
+[[nodiscard]] inline auto utf8_decode(
+	const char* it, 
+	const char* end, 
+	char32_t& cp
+) noexcept -> size_t {
+	PRECOOKED_ASSERT(it < end);
+	const auto byte_f = [](const char c) noexcept { return static_cast<uint8_t>(c); };
+	const auto b0 = byte_f(it[0]);
+	if (b0 < 0x80) PRECOOKED_LIKELY {
+		cp = b0;
+		return 1;
+	}
+	const auto available = static_cast<size_t>(end - it);
+	const auto is_continuation_f = [&](const size_t i) noexcept {
+		return i < available && (byte_f(it[i]) & 0xC0) == 0x80;
+	};
+	const auto b1 = available > 1 ? byte_f(it[1]) : uint8_t{ 0 };
+	if (b0 >= 0xC2 && b0 <= 0xDF && is_continuation_f(1)) {
+		cp = (char32_t{ b0 } & 0x1F) << 6 | (b1 & 0x3F);
+		return 2;
+	}
+	if (b0 >= 0xE0 && b0 <= 0xEF && is_continuation_f(1) && is_continuation_f(2)) {
+		// Rejects overlong encodings and surrogates
+		const auto is_valid =
+			(b0 != 0xE0 || b1 >= 0xA0) &&
+			(b0 != 0xED || b1 <= 0x9F);
+		if (is_valid) {
+			cp = (char32_t{ b0 } & 0x0F) << 12 | (b1 & 0x3F) << 6 | (byte_f(it[2]) & 0x3F);
+			return 3;
+		}
+	}
+	if (b0 >= 0xF0 && b0 <= 0xF4 && is_continuation_f(1) && is_continuation_f(2) && is_continuation_f(3)) {
+		// Rejects overlong encodings and code points beyond U+10FFFF
+		const auto is_valid =
+			(b0 != 0xF0 || b1 >= 0x90) &&
+			(b0 != 0xF4 || b1 <= 0x8F);
+		if (is_valid) {
+			cp = 
+				(char32_t{ b0 } & 0x07) << 18 | 
+				(b1 & 0x3F) << 12 | 
+				(byte_f(it[2]) & 0x3F) << 6 | 
+				(byte_f(it[3]) & 0x3F);
+			return 4;
+		}
+	}
+	cp = utf8_invalid_byte_base + b0;
+	return 1;
+}
+
+inline auto utf8_encode(const char32_t cp, std::string& out) -> void {
+	const auto char_f = [](const char32_t bits) { return static_cast<char>(bits); };
+	if (cp < 0x80) {
+		out += char_f(cp);
+	}
+	else if (cp < 0x800) {
+		out += char_f(0xC0 | cp >> 6);
+		out += char_f(0x80 | (cp & 0x3F));
+	}
+	else if (cp >= utf8_invalid_byte_base + 0x80 && cp <= utf8_invalid_byte_base + 0xFF) {
+		out += char_f(cp - utf8_invalid_byte_base);
+	}
+	else if (cp < 0x10000) {
+		out += char_f(0xE0 | cp >> 12);
+		out += char_f(0x80 | (cp >> 6 & 0x3F));
+		out += char_f(0x80 | (cp & 0x3F));
+	}
+	else {
+		out += char_f(0xF0 | cp >> 18);
+		out += char_f(0x80 | (cp >> 12 & 0x3F));
+		out += char_f(0x80 | (cp >> 6 & 0x3F));
+		out += char_f(0x80 | (cp & 0x3F));
+	}
+}
+
+// Input is processed in blocks of this size while it is pure ASCII
+constexpr auto utf8_ascii_block_size = size_t{ 32 };
+
+[[nodiscard]] inline auto utf8_is_ascii_block(const char* p) noexcept -> bool {
+#if PRECOOKED_AVX2
+	return _mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))) == 0;
+#elif PRECOOKED_SSE2
+	const auto v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+	const auto v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+	return _mm_movemask_epi8(_mm_or_si128(v0, v1)) == 0;
+#else
+	uint64_t words[4]{};
+	std::memcpy(words, p, sizeof(words));
+	return ((words[0] | words[1] | words[2] | words[3]) & 0x8080808080808080ull) == 0;
+#endif
+}
+
+// Bit i is set if the ASCII char p[i] folds to folded_c
+[[nodiscard]] inline auto utf8_ascii_block_matches(const char* p, const char folded_c) noexcept -> uint32_t {
+#if PRECOOKED_AVX2
+	const auto v = ascii_to_lower_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+	return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(folded_c))));
+#elif PRECOOKED_SSE2
+	const auto c = _mm_set1_epi8(folded_c);
+	const auto v0 = ascii_to_lower_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+	const auto v1 = ascii_to_lower_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)));
+	const auto mask0 = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v0, c)));
+	const auto mask1 = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v1, c)));
+	return mask0 | mask1 << 16;
+#else
+	auto mask = uint32_t{ 0 };
+	for (uint32_t i = 0; i < utf8_ascii_block_size; ++i) {
+		mask |= static_cast<uint32_t>(ascii_to_lower(p[i]) == folded_c) << i;
+	}
+	return mask;
+#endif
+}
+
+// Haystack at offset starts with needle, compared code point by code point
+[[nodiscard]] inline auto utf8_is_match_ignore_case_at(
+	const std::string_view& haystack,
+	const size_t offset,
+	const std::string_view& needle
+) noexcept -> bool {
+	const auto* h = haystack.data() + offset;
+	const auto* h_end = haystack.data() + haystack.size();
+	const auto* n = needle.data();
+	const auto* n_end = needle.data() + needle.size();
+	while (n != n_end) {
+		if (h == h_end) {
+			return false;
+		}
+		auto h_cp = char32_t{};
+		auto n_cp = char32_t{};
+		h += utf8_decode(h, h_end, h_cp);
+		n += utf8_decode(n, n_end, n_cp);
+		if (h_cp != n_cp && utf8_fold_case(h_cp) != utf8_fold_case(n_cp)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+}
+
+
+auto peo::utf8::to_lower(std::string_view str) -> std::string {
+	constexpr auto block_size = detail::utf8_ascii_block_size;
+	const auto* first = str.data();
+	const auto* last = str.data() + str.size();
+	auto result = std::string{};
+	result.reserve(str.size());
+	for (const auto* it = first; it != last;) {
+		const auto* ascii_end = it;
+		while (static_cast<size_t>(last - ascii_end) >= block_size && detail::utf8_is_ascii_block(ascii_end)) {
+			ascii_end += block_size;
+		}
+		if (ascii_end != it) {
+			const auto size = static_cast<size_t>(ascii_end - it);
+			const auto offset = result.size();
+			result.append(it, size);
+			const auto fold_char_f = [](const char c) noexcept { return detail::ascii_to_lower(c); };
+			detail::impl_fold_ascii<false, true>(it, size, result.data() + offset, fold_char_f);
+			it = ascii_end;
+			continue;
+		}
+		auto cp = char32_t{};
+		it += detail::utf8_decode(it, last, cp);
+		detail::utf8_encode(detail::utf8_to_lower(cp), result);
+	}
+	return result;
+}
+
+auto peo::utf8::find_ignore_case(
+	std::string_view haystack, 
+	std::string_view needle, 
+	size_t offset
+) noexcept -> size_t {
+	constexpr auto npos = std::string_view::npos;
+	constexpr auto block_size = detail::utf8_ascii_block_size;
+	if (needle.empty() || offset >= haystack.size()) {
+		return npos;
+	}
+	auto needle_front = char32_t{};
+	static_cast<void>(detail::utf8_decode(needle.data(), needle.data() + needle.size(), needle_front));
+	const auto folded_front = detail::utf8_fold_case(needle_front);
+	// No ASCII char folds to a non-ASCII code point, hence such a needle can skip ASCII blocks entirely
+	const auto is_ascii_front = folded_front < 0x80;
+	const auto* data = haystack.data();
+	const auto* last = haystack.data() + haystack.size();
+	for (auto i = offset; i < haystack.size();) {
+		if (haystack.size() - i >= block_size && detail::utf8_is_ascii_block(data + i)) {
+			auto matches = is_ascii_front ?
+				detail::utf8_ascii_block_matches(data + i, static_cast<char>(folded_front)) :
+				uint32_t{ 0 };
+			for (; matches != 0; matches &= matches - 1) {
+				const auto candidate = i + detail::count_trailing_zeros(matches);
+				if (detail::utf8_is_match_ignore_case_at(haystack, candidate, needle)) {
+					return candidate;
+				}
+			}
+			i += block_size;
+			continue;
+		}
+		auto cp = char32_t{};
+		const auto cp_size = detail::utf8_decode(data + i, last, cp);
+		if (detail::utf8_fold_case(cp) == folded_front && detail::utf8_is_match_ignore_case_at(haystack, i, needle)) {
+			return i;
+		}
+		i += cp_size;
+	}
+	return npos;
+}
+
+auto peo::utf8::is_equal_ignore_case(
+	std::string_view a, 
+	std::string_view b
+) noexcept -> bool {
+	constexpr auto block_size = detail::utf8_ascii_block_size;
+	const auto* a_it = a.data();
+	const auto* b_it = b.data();
+	const auto* a_end = a.data() + a.size();
+	const auto* b_end = b.data() + b.size();
+	while (a_it != a_end && b_it != b_end) {
+		const auto is_ascii_blocks =
+			static_cast<size_t>(a_end - a_it) >= block_size &&
+			static_cast<size_t>(b_end - b_it) >= block_size &&
+			detail::utf8_is_ascii_block(a_it) &&
+			detail::utf8_is_ascii_block(b_it);
+		if (is_ascii_blocks) {
+			if (!detail::impl_is_equal_ascii_ignore_case(a_it, b_it, block_size)) {
+				return false;
+			}
+			a_it += block_size;
+			b_it += block_size;
+			continue;
+		}
+		auto a_cp = char32_t{};
+		auto b_cp = char32_t{};
+		a_it += detail::utf8_decode(a_it, a_end, a_cp);
+		b_it += detail::utf8_decode(b_it, b_end, b_cp);
+		if (a_cp != b_cp && detail::utf8_fold_case(a_cp) != detail::utf8_fold_case(b_cp)) {
+			return false;
+		}
+	}
+	return a_it == a_end && b_it == b_end;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdexcept>
+#include <utility>
+
+namespace peo::detail {
+
+// Lowercases the ASCII letters among 8 chars at once
+[[nodiscard]] constexpr auto swar_ascii_to_lower(const uint64_t word) noexcept -> uint64_t {
+	constexpr auto ones = 0x0101010101010101ull;
+	constexpr auto high_bits = 0x8080808080808080ull;
+	const auto heptets = word & ~high_bits;
+	const auto is_at_least_A = heptets + ones * (0x80 - 'A');
+	const auto is_beyond_Z = heptets + ones * (0x80 - 'Z' - 1);
+	const auto is_upper = (is_at_least_A ^ is_beyond_Z) & ~word & high_bits;
+	return word | (is_upper >> 2);
+}
+
+constexpr auto hash_multiplier = uint64_t{ 0x9E3779B97F4A7C15ull };
+
+[[nodiscard]] constexpr auto hash_mix(const uint64_t hash, const uint64_t word) noexcept -> uint64_t {
+	const auto mixed = (hash ^ word) * hash_multiplier;
+	return mixed ^ (mixed >> 32);
+}
+
+template <typename Char>
+[[nodiscard]] constexpr auto ascii_to_lower_any(const Char c) noexcept -> Char {
+	return c >= Char('A') && c <= Char('Z') ? static_cast<Char>(c | 0x20) : c;
+}
+
+}
+
+
+// Hashes strings with their ASCII letters lowercased, like the classic locale 
+// folds them. Transparent, so differing string types can be looked up.
+struct peo::hash_ignore_case {
+	using is_transparent = void;
+	template <typename Str>
+	[[nodiscard]] auto operator()(const Str& str) const noexcept -> size_t {
+		using Char = type_traits::underlying_char_t<Str>;
+		static_assert(type_traits::is_valid_char_v<Char>);
+		const auto sv = std::basic_string_view<Char>{ str };
+		auto hash = detail::hash_mix(0, sv.size());
+		if constexpr (std::is_same_v<Char, char>) {
+			// Folds and mixes 8 chars at a time
+			auto i = size_t{ 0 };
+			for (; i + 8 <= sv.size(); i += 8) {
+				auto word = uint64_t{ 0 };
+				std::memcpy(&word, sv.data() + i, 8);
+				hash = detail::hash_mix(hash, detail::swar_ascii_to_lower(word));
+			}
+			if (i != sv.size()) {
+				auto word = uint64_t{ 0 };
+				std::memcpy(&word, sv.data() + i, sv.size() - i);
+				hash = detail::hash_mix(hash, detail::swar_ascii_to_lower(word));
+			}
+		}
+		else {
+			for (const auto c : sv) {
+				hash = detail::hash_mix(hash, static_cast<uint64_t>(detail::ascii_to_lower_any(c)));
+			}
+		}
+		return static_cast<size_t>(hash);
+	}
+};
+
+// Compares strings with their ASCII letters lowercased, consistent with peo::hash_ignore_case
+struct peo::equal_ignore_case {
+	using is_transparent = void;
+	template <typename Str0, typename Str1>
+	[[nodiscard]] auto operator()(const Str0& a, const Str1& b) const noexcept -> bool {
+		using Char = type_traits::underlying_char_t<Str0>;
+		static_assert(type_traits::is_valid_char_v<Char>);
+		const auto a_sv = std::basic_string_view<Char>{ a };
+		const auto b_sv = std::basic_string_view<Char>{ b };
+		if (a_sv.size() != b_sv.size()) {
+			return false;
+		}
+		if constexpr (std::is_same_v<Char, char>) {
+			return detail::impl_is_equal_ascii_ignore_case(a_sv.data(), b_sv.data(), a_sv.size());
+		}
+		else {
+			const auto is_equal_f = [](const Char& lhs, const Char& rhs) noexcept {
+				return detail::ascii_to_lower_any(lhs) == detail::ascii_to_lower_any(rhs);
+			};
+			return std::equal(a_sv.begin(), a_sv.end(), b_sv.begin(), is_equal_f);
+		}
+	}
+};
+
+
+// Open addressing hash map with std::string keys compared by peo::equal_ignore_case.
+// Entries are stored contiguously in insertion order until an erase, which moves 
+// the last entry into the gap. The slots only hold a hash tag and an entry index, 
+// are probed linearly and erased by backward shifting, hence there are no tombstones.
+// Lookups take any string convertible to std::string_view and never allocate.
+// Keys must not be modified through iterators.
+template <typename Value>
+class peo::flat_map_ignore_case {
+public:
+	using key_type = std::string;
+	using mapped_type = Value;
+	using value_type = std::pair<std::string, Value>;
+	using iterator = typename std::vector<value_type>::iterator;
+	using const_iterator = typename std::vector<value_type>::const_iterator;
+
+	flat_map_ignore_case() = default;
+	flat_map_ignore_case(std::initializer_list<value_type> entries) {
+		reserve(entries.size());
+		for (const auto& entry : entries) {
+			insert_or_assign(entry.first, entry.second);
+		}
+	}
+
+	[[nodiscard]] auto size() const noexcept -> size_t { return entries_.size(); }
+	[[nodiscard]] auto empty() const noexcept -> bool { return entries_.empty(); }
+	[[nodiscard]] auto begin() noexcept -> iterator { return entries_.begin(); }
+	[[nodiscard]] auto end() noexcept -> iterator { return entries_.end(); }
+	[[nodiscard]] auto begin() const noexcept -> const_iterator { return entries_.begin(); }
+	[[nodiscard]] auto end() const noexcept -> const_iterator { return entries_.end(); }
+
+	auto clear() noexcept -> void {
+		entries_.clear();
+		slots_.clear();
+	}
+	auto reserve(const size_t num_entries) -> void {
+		entries_.reserve(num_entries);
+		const auto num_slots = required_num_slots(num_entries);
+		if (num_slots > slots_.size()) {
+			rehash(num_slots);
+		}
+	}
+
+	[[nodiscard]] auto find(const std::string_view key) noexcept -> iterator {
+		const auto slot_idx = find_slot(key, hash_ignore_case{}(key));
+		return slot_idx == npos ? end() : begin() + slots_[slot_idx].entry_idx;
+	}
+	[[nodiscard]] auto find(const std::string_view key) const noexcept -> const_iterator {
+		const auto slot_idx = find_slot(key, hash_ignore_case{}(key));
+		return slot_idx == npos ? end() : begin() + slots_[slot_idx].entry_idx;
+	}
+	[[nodiscard]] auto contains(const std::string_view key) const noexcept -> bool {
+		return find(key) != end();
+	}
+	[[nodiscard]] auto at(const std::string_view key) -> Value& {
+		const auto it = find(key);
+		if (it == end()) {
+			throw std::out_of_range{ "peo::flat_map_ignore_case::at, key not found" };
+		}
+		return it->second;
+	}
+	[[nodiscard]] auto at(const std::string_view key) const -> const Value& {
+		const auto it = find(key);
+		if (it == end()) {
+			throw std::out_of_range{ "peo::flat_map_ignore_case::at, key not found" };
+		}
+		return it->second;
+	}
+	auto operator[](const std::string_view key) -> Value& {
+		return try_emplace(key).first->second;
+	}
+
+	// Keeps the existing value, if any, and the spelling of its key
+	template <typename... Args>
+	auto try_emplace(const std::string_view key, Args&&... args) -> std::pair<iterator, bool> {
+		const auto hash = hash_ignore_case{}(key);
+		if (const auto slot_idx = find_slot(key, hash); slot_idx != npos) {
+			return { begin() + slots_[slot_idx].entry_idx, false };
+		}
+		if (required_num_slots(entries_.size() + 1) > slots_.size()) {
+			rehash(std::max(min_num_slots, slots_.size() * 2));
+		}
+		const auto entry_idx = entries_.size();
+		entries_.emplace_back(
+			std::piecewise_construct,
+			std::forward_as_tuple(key),
+			std::forward_as_tuple(std::forward<Args>(args)...)
+		);
+		place_slot(hash, entry_idx);
+		return { begin() + entry_idx, true };
+	}
+	template <typename V>
+	auto insert_or_assign(const std::string_view key, V&& value) -> std::pair<iterator, bool> {
+		auto result = try_emplace(key, std::forward<V>(value));
+		if (!result.second) {
+			result.first->second = std::forward<V>(value);
+		}
+		return result;
+	}
 
-template <typename Str0, typename Str1>
-auto peo::find_ignore_case(
-	const Str0& haystack,
-	const Str1& needle,
-	const size_t offset,
-	const std::locale& loc
-) noexcept -> size_t {
-	using Char = type_traits::underlying_char_t<Str0>;
-	static_assert(type_traits::is_valid_char_v<Char>);
-	const auto haystack_sv = std::basic_string_view<Char>{ haystack };
-	const auto needle_sv = std::basic_string_view<Char>{ needle };
-	const auto cannot_possibly_exist =
-		haystack_sv.size() < needle_sv.size() || 
-		needle_sv.empty();
-	if (cannot_possibly_exist) {
-		return std::string::npos;
+	auto erase(const std::string_view key) -> size_t {
+		const auto slot_idx = find_slot(key, hash_ignore_case{}(key));
+		if (slot_idx == npos) {
+			return 0;
+		}
+		const auto entry_idx = slots_[slot_idx].entry_idx;
+		erase_slot(slot_idx);
+		// Fills the gap with the last entry and redirects its slot
+		const auto last_idx = static_cast<uint32_t>(entries_.size() - 1);
+		if (entry_idx != last_idx) {
+			entries_[entry_idx] = std::move(entries_[last_idx]);
+			const auto mask = slots_.size() - 1;
+			auto i = hash_ignore_case{}(entries_[entry_idx].first) & mask;
+			while (slots_[i].entry_idx != last_idx) {
+				PRECOOKED_ASSERT(slots_[i].entry_idx != empty_entry_idx);
+				i = (i + 1) & mask;
+			}
+			slots_[i].entry_idx = entry_idx;
+		}
+		entries_.pop_back();
+		return 1;
+	}
+	auto erase(const const_iterator it) -> iterator {
+		const auto idx = static_cast<size_t>(std::distance(entries_.cbegin(), it));
+		// Copied, as the key is overwritten by the moved last entry
+		const auto key = std::string{ it->first };
+		erase(key);
+		return begin() + idx;
 	}
-	return detail::impl_find_ignore_case(
-		std::basic_string_view<Char>{haystack_sv},
-		std::basic_string_view<Char>{needle_sv},
-		offset,
-		loc
-	);
-}
 
-template <typename Str0, typename Str1>
-auto peo::find_ignore_case(
-	const Str0& haystack,
-	const Str1& needle,
-	const std::locale& loc
-) noexcept -> size_t {
-	return find_ignore_case(
-		haystack,
-		needle,
-		size_t{ 0 },
-		loc
-	);
-}
+private:
+	struct slot_t {
+		uint32_t hash_tag{ 0 };
+		uint32_t entry_idx{ empty_entry_idx };
+	};
+	static constexpr auto empty_entry_idx = uint32_t{ 0xFFFFFFFF };
+	static constexpr auto npos = size_t(-1);
+	static constexpr auto min_num_slots = size_t{ 16 };
+
+	// At most half of the slots are occupied, which keeps linear probe sequences short
+	[[nodiscard]] static auto required_num_slots(const size_t num_entries) noexcept -> size_t {
+		auto num_slots = min_num_slots;
+		while (num_slots < num_entries * 2) {
+			num_slots *= 2;
+		}
+		return num_slots;
+	}
+	[[nodiscard]] auto find_slot(const std::string_view key, const size_t hash) const noexcept -> size_t {
+		if (slots_.empty()) {
+			return npos;
+		}
+		const auto mask = slots_.size() - 1;
+		const auto tag = static_cast<uint32_t>(hash);
+		for (auto i = hash & mask;; i = (i + 1) & mask) {
+			const auto& slot = slots_[i];
+			if (slot.entry_idx == empty_entry_idx) {
+				return npos;
+			}
+			if (slot.hash_tag == tag && equal_ignore_case{}(entries_[slot.entry_idx].first, key)) {
+				return i;
+			}
+		}
+	}
+	auto place_slot(const size_t hash, const size_t entry_idx) noexcept -> void {
+		const auto mask = slots_.size() - 1;
+		auto i = hash & mask;
+		while (slots_[i].entry_idx != empty_entry_idx) {
+			i = (i + 1) & mask;
+		}
+		slots_[i] = slot_t{ static_cast<uint32_t>(hash), static_cast<uint32_t>(entry_idx) };
+	}
+	// Shifts back the following slots of the probe sequence, so no lookup passes an empty slot
+	auto erase_slot(size_t hole) noexcept -> void {
+		const auto mask = slots_.size() - 1;
+		for (auto i = (hole + 1) & mask; slots_[i].entry_idx != empty_entry_idx; i = (i + 1) & mask) {
+			// The tag holds the low bits of the hash, which index the home slot
+			const auto home = slots_[i].hash_tag & mask;
+			const auto is_home_after_hole = hole <= i ?
+				hole < home && home <= i :
+				hole < home || home <= i;
+			if (!is_home_after_hole) {
+				slots_[hole] = slots_[i];
+				hole = i;
+			}
+		}
+		slots_[hole] = slot_t{};
+	}
+	auto rehash(const size_t num_slots) -> void {
+		PRECOOKED_ASSERT((num_slots & (num_slots - 1)) == 0);
+		PRECOOKED_ASSERT(num_slots - 1 <= empty_entry_idx);
+		slots_.assign(num_slots, slot_t{});
+		for (size_t i = 0; i < entries_.size(); ++i) {
+			place_slot(hash_ignore_case{}(entries_[i].first), i);
+		}
+	}
+	std::vector<value_type> entries_{};
+	std::vector<slot_t> slots_{};
+};
 
 
 //////////////////////////////////////////////////////////////////////////////
@@ -1798,23 +5978,32 @@ auto peo::read_file_to_vector(
 }
 
 
+namespace peo::detail {
+inline auto create_parent_directories(
+	const std::filesystem::path& filepath
+) -> void {
+	if (!filepath.has_parent_path()) {
+		return;
+	}
+	const auto dir = filepath.parent_path();
+	if (!std::filesystem::exists(dir)) {
+		std::filesystem::create_directories(dir);
+	}
+	if (!std::filesystem::exists(dir)) {
+		throw peo::exceptions::dir_not_found_exception{ dir };
+	}
+	if (!std::filesystem::is_directory(dir)) {
+		throw peo::exceptions::is_not_directory_exception{ dir };
+	}
+}
+}
+
 // Write files
 auto peo::write_vector_to_file(
 	const detail::byte_view& byteview, 
 	const std::filesystem::path& filepath
 ) -> void {
-	if (filepath.has_parent_path()) {
-		const auto dir = filepath.parent_path();
-		if (!std::filesystem::exists(dir)) {
-			std::filesystem::create_directories(dir);
-		}
-		if (!std::filesystem::exists(dir)) {
-			throw peo::exceptions::dir_not_found_exception{ dir };
-		}
-		if (!std::filesystem::is_directory(dir)) {
-			throw peo::exceptions::is_not_directory_exception{ dir };
-		}
-	}
+	detail::create_parent_directories(filepath);
 	auto file_stream = std::ofstream{ filepath, std::ios::binary };
 	if (!file_stream.is_open()) {
 		throw peo::exceptions::write_file_exception{ filepath };
@@ -1846,6 +6035,246 @@ auto peo::write_string_to_file(
 
 
 
+namespace peo::detail {
+// Size of the chunks read when streaming files
+constexpr auto file_chunk_size = size_t{ 1 } << 20;
+}
+
+// Replace in files
+template <typename Str0, typename Str1>
+auto peo::replace_all_in_file(
+	const std::filesystem::path& src_filepath,
+	const std::filesystem::path& dst_filepath,
+	const Str0& needle,
+	const Str1& replacement
+) -> size_t {
+	static_assert(std::is_same_v<type_traits::underlying_char_t<Str0>, char>);
+	static_assert(std::is_same_v<type_traits::underlying_char_t<Str1>, char>);
+	const auto needle_sv = std::string_view{ needle };
+	const auto replacement_sv = std::string_view{ replacement };
+	if (!std::filesystem::exists(src_filepath)) {
+		throw peo::exceptions::file_not_found_exception(src_filepath);
+	}
+	if (!std::filesystem::is_regular_file(src_filepath)) {
+		throw peo::exceptions::is_not_file_exception(src_filepath);
+	}
+	if (
+		std::filesystem::exists(dst_filepath) && 
+		std::filesystem::equivalent(src_filepath, dst_filepath)
+	) {
+		throw std::invalid_argument{ "source and destination cannot be the same file" };
+	}
+	detail::create_parent_directories(dst_filepath);
+	auto src_stream = std::ifstream{ src_filepath, std::ios::binary };
+	if (!src_stream.is_open()) {
+		throw peo::exceptions::read_file_exception{ src_filepath };
+	}
+	auto dst_stream = std::ofstream{ dst_filepath, std::ios::binary };
+	if (!dst_stream.is_open()) {
+		throw peo::exceptions::write_file_exception{ dst_filepath };
+	}
+	const auto write_f = [&dst_stream, &dst_filepath](const std::string_view& sv) {
+		dst_stream.write(sv.data(), static_cast<std::streamsize>(sv.size()));
+		if (!dst_stream) PRECOOKED_UNLIKELY {
+			throw peo::exceptions::write_file_exception{ dst_filepath };
+		}
+	};
+	// The part of a chunk which may hold the beginning of a needle 
+	// is carried over to the next chunk
+	const auto max_carry_size = needle_sv.empty() ? size_t{ 0 } : needle_sv.size() - 1;
+	auto buffer = std::string{};
+	buffer.resize(detail::file_chunk_size + max_carry_size);
+	auto carry_size = size_t{ 0 };
+	auto num_replacements = size_t{ 0 };
+	for (;;) {
+		src_stream.read(buffer.data() + carry_size, static_cast<std::streamsize>(detail::file_chunk_size));
+		if (src_stream.bad()) PRECOOKED_UNLIKELY {
+			throw peo::exceptions::read_file_exception{ src_filepath };
+		}
+		const auto num_read = static_cast<size_t>(src_stream.gcount());
+		const auto is_last_chunk = num_read < detail::file_chunk_size;
+		const auto chunk = std::string_view{ buffer.data(), carry_size + num_read };
+		auto pos = size_t{ 0 };
+		if (!needle_sv.empty()) {
+			for (
+				auto match = chunk.find(needle_sv);
+				match != std::string_view::npos;
+				match = chunk.find(needle_sv, pos)
+			) {
+				write_f(chunk.substr(pos, match - pos));
+				write_f(replacement_sv);
+				pos = match + needle_sv.size();
+				++num_replacements;
+			}
+		}
+		if (is_last_chunk) {
+			write_f(chunk.substr(pos));
+			break;
+		}
+		const auto carry_begin = std::max(pos, chunk.size() - std::min(max_carry_size, chunk.size()));
+		write_f(chunk.substr(pos, carry_begin - pos));
+		carry_size = chunk.size() - carry_begin;
+		std::copy(chunk.begin() + carry_begin, chunk.end(), buffer.begin());
+	}
+	return num_replacements;
+}
+
+
+
+// Memory mapped files are utilized where POSIX mmap is available
+#ifndef PRECOOKED_HAS_MMAP
+	#if defined(__has_include)
+		#if __has_include(<sys/mman.h>) && __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+			#define PRECOOKED_HAS_MMAP 1
+		#endif
+	#endif
+#endif
+#ifndef PRECOOKED_HAS_MMAP
+	#define PRECOOKED_HAS_MMAP 0
+#endif
+#if PRECOOKED_HAS_MMAP
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+
+namespace peo::detail {
+class patch_result_t {
+public:
+	size_t num_replacements{ 0 };
+	size_t dirty_begin{ 0 }; // Modified byte range within the chunk
+	size_t dirty_end{ 0 };
+};
+
+// Patches a file in place, patch_f(data, size, file_offset) is invoked 
+// for every chunk and never patches a match which is not entirely within the chunk.
+#if PRECOOKED_HAS_MMAP
+template <typename PatchFunc>
+[[nodiscard]] auto impl_patch_file_inplace(
+	const std::filesystem::path& filepath,
+	const size_t file_size,
+	const size_t /*needle_size*/,
+	const PatchFunc& patch_f
+) -> size_t {
+	// The file is mapped read-write, only pages holding a patched 
+	// match become dirty and are written back
+	const auto fd = ::open(filepath.c_str(), O_RDWR);
+	if (fd < 0) {
+		throw peo::exceptions::write_file_exception{ filepath };
+	}
+	void* mapping = ::mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (mapping == MAP_FAILED) {
+		throw peo::exceptions::io_exception{ "cannot map file", filepath };
+	}
+	const auto scope_exit = detail::scope_exit{ [mapping, file_size]() {
+		::munmap(mapping, file_size);
+	} };
+	return patch_f(static_cast<char*>(mapping), file_size, size_t{ 0 }).num_replacements;
+}
+#else
+template <typename PatchFunc>
+[[nodiscard]] auto impl_patch_file_inplace(
+	const std::filesystem::path& filepath,
+	const size_t file_size,
+	const size_t needle_size,
+	const PatchFunc& patch_f
+) -> size_t {
+	// Without memory mapping the file is patched chunk by chunk, 
+	// and only the modified range of a chunk is written back
+	auto file_stream = std::fstream{ filepath, std::ios::in | std::ios::out | std::ios::binary };
+	if (!file_stream.is_open()) {
+		throw peo::exceptions::write_file_exception{ filepath };
+	}
+	auto buffer = std::string{};
+	auto num_replacements = size_t{ 0 };
+	for (auto chunk_offset = size_t{ 0 }; chunk_offset < file_size;) {
+		const auto chunk_size = std::min(file_chunk_size, file_size - chunk_offset);
+		buffer.resize(chunk_size);
+		file_stream.seekg(static_cast<std::streamoff>(chunk_offset));
+		file_stream.read(buffer.data(), static_cast<std::streamsize>(chunk_size));
+		if (!file_stream) PRECOOKED_UNLIKELY {
+			throw peo::exceptions::read_file_exception{ filepath };
+		}
+		const auto result = patch_f(buffer.data(), chunk_size, chunk_offset);
+		if (result.dirty_begin < result.dirty_end) {
+			file_stream.seekp(static_cast<std::streamoff>(chunk_offset + result.dirty_begin));
+			file_stream.write(
+				buffer.data() + result.dirty_begin, 
+				static_cast<std::streamsize>(result.dirty_end - result.dirty_begin)
+			);
+			if (!file_stream) PRECOOKED_UNLIKELY {
+				throw peo::exceptions::write_file_exception{ filepath };
+			}
+		}
+		num_replacements += result.num_replacements;
+		if (chunk_offset + chunk_size == file_size) {
+			break;
+		}
+		// Overlap the chunks, so that every match is entirely within a chunk
+		chunk_offset += chunk_size - std::min(chunk_size - 1, needle_size - 1);
+	}
+	return num_replacements;
+}
+#endif
+}
+
+
+template <typename Str0, typename Str1>
+auto peo::replace_all_in_file_inplace(
+	const std::filesystem::path& filepath,
+	const Str0& needle,
+	const Str1& replacement
+) -> size_t {
+	static_assert(std::is_same_v<type_traits::underlying_char_t<Str0>, char>);
+	static_assert(std::is_same_v<type_traits::underlying_char_t<Str1>, char>);
+	const auto needle_sv = std::string_view{ needle };
+	const auto replacement_sv = std::string_view{ replacement };
+	if (needle_sv.size() != replacement_sv.size()) {
+		throw std::invalid_argument{ "needle and replacement must be of equal size" };
+	}
+	if (!std::filesystem::exists(filepath)) {
+		throw peo::exceptions::file_not_found_exception(filepath);
+	}
+	if (!std::filesystem::is_regular_file(filepath)) {
+		throw peo::exceptions::is_not_file_exception(filepath);
+	}
+	const auto file_size_uintmax = std::filesystem::file_size(filepath);
+	const auto file_size_optional = detail::filesize_to_size_t(file_size_uintmax);
+	if (!file_size_optional.has_value()) {
+		throw peo::exceptions::file_too_large_exception(filepath, file_size_uintmax);
+	}
+	const auto file_size = *file_size_optional;
+	if (needle_sv.empty() || needle_sv.size() > file_size) {
+		return 0;
+	}
+	const auto searcher = peo::searcher{ needle_sv };
+	auto resume_offset = size_t{ 0 }; // Overlapping chunks must not match within a patched match
+	const auto patch_f = [&](char* data, const size_t size, const size_t file_offset) noexcept {
+		const auto chunk = std::string_view{ data, size };
+		auto result = detail::patch_result_t{};
+		for (
+			auto idx = searcher.find(chunk, resume_offset > file_offset ? resume_offset - file_offset : 0);
+			idx != std::string_view::npos;
+			idx = searcher.find(chunk, idx + needle_sv.size())
+		) {
+			// Leave unchanged bytes untouched, in order to not dirty the page
+			if (chunk.substr(idx, needle_sv.size()) != replacement_sv) {
+				std::copy(replacement_sv.begin(), replacement_sv.end(), data + idx);
+				result.dirty_begin = result.dirty_end == 0 ? idx : result.dirty_begin;
+				result.dirty_end = idx + needle_sv.size();
+			}
+			resume_offset = file_offset + idx + needle_sv.size();
+			++result.num_replacements;
+		}
+		return result;
+	};
+	return detail::impl_patch_file_inplace(filepath, file_size, needle_sv.size(), patch_f);
+}
+
+
+
 
 
 
@@ -1977,6 +6406,393 @@ auto peo::list_subdirs_in_directory_tree(
 
 
 
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+// Glob patterns
+#include <array>
+#include <filesystem>
+#include <initializer_list>
+#include <string_view>
+#include <vector>
+
+// Matches whole strings against glob patterns, '/' separates path segments:
+//   *   Any chars except '/'
+//   ?   Any char except '/'
+//   **  Any number of whole segments, as "**/" or a trailing "/**"
+//   [abc] [a-z] [!a-z] [^a-z]  Any of (or none of) the chars, except '/'
+// A '[' without a closing ']' is a literal. Several patterns are matched at once, 
+// as a union. The patterns are compiled to a single NFA, which is simulated with 
+// bit-parallel state sets, so matching is linear in the length of the string.
+// IgnoreCase folds ASCII letters like the classic locale.
+template <bool IgnoreCase>
+class peo::basic_glob_pattern {
+public:
+	explicit basic_glob_pattern(const std::string_view pattern) {
+		add_pattern(pattern);
+		build();
+	}
+	basic_glob_pattern(std::initializer_list<std::string_view> patterns) {
+		for (const auto& pattern : patterns) {
+			add_pattern(pattern);
+		}
+		build();
+	}
+	template <typename Strings, std::enable_if_t<!std::is_convertible_v<const Strings&, std::string_view>, int> = 0>
+	explicit basic_glob_pattern(const Strings& patterns) {
+		for (const auto& pattern : patterns) {
+			add_pattern(std::string_view{ pattern });
+		}
+		build();
+	}
+
+	// True if any of the patterns matches the whole string
+	[[nodiscard]] auto matches(const std::string_view str) const -> bool {
+		const auto is_prefix_f = [](const std::string_view s, const std::string_view prefix) noexcept {
+			return s.size() >= prefix.size() && is_equal_chars(s.data(), prefix.data(), prefix.size());
+		};
+		// The state sets are on the stack, unless there are many patterns
+		uint64_t inline_states[2 * max_inline_words]{};
+		auto heap_states = std::vector<uint64_t>{};
+		uint64_t* states = nullptr;
+		for (const auto& info : infos_) {
+			const auto is_viable =
+				str.size() >= info.min_size &&
+				is_prefix_f(str, info.prefix) &&
+				is_prefix_f(str.substr(str.size() - std::min(str.size(), info.suffix.size())), info.suffix);
+			if (!is_viable) {
+				continue;
+			}
+			if (info.is_literal) {
+				if (str.size() == info.prefix.size()) {
+					return true;
+				}
+				continue;
+			}
+			if (states == nullptr) {
+				if (num_words_ <= max_inline_words) {
+					states = inline_states;
+				}
+				else {
+					heap_states.assign(num_words_ * 2, 0);
+					states = heap_states.data();
+				}
+			}
+			states[info.start_state / 64] |= uint64_t{ 1 } << (info.start_state % 64);
+		}
+		if (states == nullptr) {
+			return false;
+		}
+		auto* current = states;
+		auto* next = states + num_words_;
+		add_epsilon_closure(current);
+		for (const auto c : str) {
+			const auto* consume_mask = consume_masks_.data() + to_idx(c) * num_words_;
+			const auto* loop_mask = loop_masks_.data() + to_idx(c) * num_words_;
+			auto carry = uint64_t{ 0 };
+			auto is_any_active = uint64_t{ 0 };
+			for (size_t w = 0; w < num_words_; ++w) {
+				const auto consumed = current[w] & consume_mask[w];
+				next[w] = (consumed << 1) | carry | (current[w] & loop_mask[w]);
+				carry = consumed >> 63;
+				is_any_active |= next[w];
+			}
+			if (is_any_active == 0) {
+				return false;
+			}
+			add_epsilon_closure(next);
+			std::swap(current, next);
+		}
+		for (size_t w = 0; w < num_words_; ++w) {
+			if ((current[w] & accept_mask_[w]) != 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+	// Matches the generic form of the path, ie with '/' as separator. A template, as 
+	// strings would convert to both std::string_view and std::filesystem::path.
+	template <typename Path, std::enable_if_t<std::is_same_v<Path, std::filesystem::path>, int> = 0>
+	[[nodiscard]] auto matches(const Path& path) const -> bool {
+		return matches(std::string_view{ path.generic_string() });
+	}
+
+private:
+	static constexpr auto max_inline_words = size_t{ 4 };
+	// NFA state with transitions on chars to itself (loop) and to the next state (consume)
+	struct state_t {
+		std::array<uint64_t, 4> consume_set{};
+		std::array<uint64_t, 4> loop_set{};
+		std::vector<size_t> epsilon_targets{};
+	};
+	// Prefilter and entry of a single pattern
+	struct pattern_info_t {
+		std::string prefix{};
+		std::string suffix{};
+		size_t min_size{ 0 };
+		bool is_literal{ false };
+		size_t start_state{ 0 };
+	};
+	[[nodiscard]] static constexpr auto to_idx(const char c) noexcept -> size_t {
+		return static_cast<unsigned char>(c);
+	}
+	[[nodiscard]] static auto is_equal_chars(const char* a, const char* b, const size_t size) noexcept -> bool {
+		if constexpr (IgnoreCase) { return detail::impl_is_equal_ascii_ignore_case(a, b, size); }
+		else { return std::equal(a, a + size, b); }
+	}
+	static auto add_char(std::array<uint64_t, 4>& set, const char c) noexcept -> void {
+		const auto add_f = [&set](const char ch) noexcept {
+			set[to_idx(ch) / 64] |= uint64_t{ 1 } << (to_idx(ch) % 64);
+		};
+		add_f(c);
+		if constexpr (IgnoreCase) {
+			add_f(detail::ascii_to_lower(c));
+			add_f(detail::ascii_to_upper(c));
+		}
+	}
+	[[nodiscard]] static auto all_chars_set(const bool include_separator) noexcept -> std::array<uint64_t, 4> {
+		auto set = std::array<uint64_t, 4>{};
+		set.fill(~uint64_t{ 0 });
+		if (!include_separator) {
+			set[to_idx('/') / 64] &= ~(uint64_t{ 1 } << (to_idx('/') % 64));
+		}
+		return set;
+	}
+	// The closing ']' of a class starting at pattern[i] == '[', or npos
+	[[nodiscard]] static auto find_class_end(const std::string_view pattern, const size_t i) noexcept -> size_t {
+		auto j = i + 1;
+		if (j < pattern.size() && (pattern[j] == '!' || pattern[j] == '^')) {
+			++j;
+		}
+		// A leading ']' is a member
+		if (j < pattern.size() && pattern[j] == ']') {
+			++j;
+		}
+		return pattern.find(']', j);
+	}
+
+	auto add_pattern(const std::string_view pattern) -> void {
+		auto info = pattern_info_t{};
+		info.start_state = states_.size();
+		auto is_literal_run = true;
+		auto literal_tail = std::string{};
+		const auto add_state_f = [this]() -> state_t& {
+			return states_.emplace_back();
+		};
+		for (size_t i = 0; i < pattern.size();) {
+			const auto c = pattern[i];
+			const auto is_segment_begin = i == 0 || pattern[i - 1] == '/';
+			if (c == '*') {
+				const auto is_double = i + 1 < pattern.size() && pattern[i + 1] == '*';
+				if (is_double && is_segment_begin && i + 2 < pattern.size() && pattern[i + 2] == '/') {
+					// "**/" is (.*/)?, an entry state skips it entirely
+					const auto entry = states_.size();
+					add_state_f().epsilon_targets = { entry + 1, entry + 3 };
+					auto& loop = add_state_f();
+					loop.loop_set = all_chars_set(true);
+					loop.epsilon_targets = { entry + 2 };
+					add_char(add_state_f().consume_set, '/');
+					i += 3;
+				}
+				else if (is_double && is_segment_begin && i + 2 == pattern.size()) {
+					// Trailing "**" matches anything
+					auto& loop = add_state_f();
+					loop.loop_set = all_chars_set(true);
+					loop.epsilon_targets = { states_.size() };
+					i += 2;
+				}
+				else {
+					auto& star = add_state_f();
+					star.loop_set = all_chars_set(false);
+					star.epsilon_targets = { states_.size() };
+					i += is_double ? 2 : 1;
+				}
+				is_literal_run = false;
+				literal_tail.clear();
+				continue;
+			}
+			auto& state = add_state_f();
+			++info.min_size;
+			if (c == '?') {
+				state.consume_set = all_chars_set(false);
+				is_literal_run = false;
+				literal_tail.clear();
+				++i;
+				continue;
+			}
+			if (const auto class_end = c == '[' ? find_class_end(pattern, i) : std::string_view::npos; class_end != std::string_view::npos) {
+				auto j = i + 1;
+				const auto is_negated = pattern[j] == '!' || pattern[j] == '^';
+				j += is_negated ? 1 : 0;
+				auto set = std::array<uint64_t, 4>{};
+				for (; j < class_end; ++j) {
+					const auto is_range = j + 2 < class_end && pattern[j + 1] == '-';
+					const auto last = is_range ? pattern[j + 2] : pattern[j];
+					for (auto ch = to_idx(pattern[j]); ch <= to_idx(last); ++ch) {
+						add_char(set, static_cast<char>(ch));
+					}
+					j += is_range ? 2 : 0;
+				}
+				const auto all = all_chars_set(false);
+				for (size_t w = 0; w < set.size(); ++w) {
+					state.consume_set[w] = (is_negated ? ~set[w] : set[w]) & all[w];
+				}
+				is_literal_run = false;
+				literal_tail.clear();
+				i = class_end + 1;
+				continue;
+			}
+			add_char(state.consume_set, c);
+			if (is_literal_run) {
+				info.prefix += c;
+			}
+			literal_tail += c;
+			++i;
+		}
+		// Accepting state
+		accepts_.push_back(states_.size());
+		add_state_f();
+		info.is_literal = is_literal_run;
+		info.suffix = is_literal_run ? std::string{} : literal_tail;
+		infos_.push_back(std::move(info));
+	}
+
+	auto build() -> void {
+		num_words_ = (states_.size() + 63) / 64;
+		consume_masks_.assign(256 * num_words_, 0);
+		loop_masks_.assign(256 * num_words_, 0);
+		accept_mask_.assign(num_words_, 0);
+		for (size_t s = 0; s < states_.size(); ++s) {
+			const auto word = s / 64;
+			const auto bit = uint64_t{ 1 } << (s % 64);
+			for (size_t c = 0; c < 256; ++c) {
+				const auto is_in_f = [c](const std::array<uint64_t, 4>& set) noexcept {
+					return ((set[c / 64] >> (c % 64)) & 1) != 0;
+				};
+				if (is_in_f(states_[s].consume_set)) { consume_masks_[c * num_words_ + word] |= bit; }
+				if (is_in_f(states_[s].loop_set)) { loop_masks_[c * num_words_ + word] |= bit; }
+			}
+			if (!states_[s].epsilon_targets.empty()) {
+				epsilon_states_.push_back(s);
+			}
+		}
+		for (const auto accept : accepts_) {
+			accept_mask_[accept / 64] |= uint64_t{ 1 } << (accept % 64);
+		}
+	}
+	// Epsilon transitions only lead forward, so a single ascending pass is complete
+	auto add_epsilon_closure(uint64_t* active) const noexcept -> void {
+		for (const auto s : epsilon_states_) {
+			if (((active[s / 64] >> (s % 64)) & 1) == 0) {
+				continue;
+			}
+			for (const auto target : states_[s].epsilon_targets) {
+				active[target / 64] |= uint64_t{ 1 } << (target % 64);
+			}
+		}
+	}
+
+	std::vector<state_t> states_{};
+	std::vector<size_t> accepts_{};
+	std::vector<pattern_info_t> infos_{};
+	std::vector<size_t> epsilon_states_{};
+	size_t num_words_{ 0 };
+	// Per char, the states consuming or looping on it
+	std::vector<uint64_t> consume_masks_{};
+	std::vector<uint64_t> loop_masks_{};
+	std::vector<uint64_t> accept_mask_{};
+};
+
+
+namespace peo::detail {
+struct glob_segment_t {
+	std::string literal{};
+	std::optional<glob_pattern> pattern{}; // Set if the segment has wildcards
+	bool is_globstar{ false };
+};
+
+inline auto impl_expand_glob(
+	const std::filesystem::path& dir,
+	const std::vector<glob_segment_t>& segments,
+	const size_t segment_idx,
+	std::vector<std::filesystem::path>& paths
+) -> void {
+	PRECOOKED_ASSERT(segment_idx < segments.size());
+	const auto& segment = segments[segment_idx];
+	const auto is_last = segment_idx + 1 == segments.size();
+	const auto match_f = [&](const std::filesystem::path& path, const bool is_directory) {
+		if (is_last) {
+			paths.push_back(path);
+		}
+		else if (is_directory) {
+			impl_expand_glob(path, segments, segment_idx + 1, paths);
+		}
+	};
+	if (segment.is_globstar) {
+		// Zero or more directories, symlinked directories are not followed like 
+		// std::filesystem::recursive_directory_iterator
+		if (!is_last) {
+			impl_expand_glob(dir, segments, segment_idx + 1, paths);
+		}
+		for (const auto& entry : std::filesystem::directory_iterator{ dir }) {
+			if (is_last) {
+				paths.push_back(entry.path());
+			}
+			if (entry.is_directory() && !entry.is_symlink()) {
+				impl_expand_glob(entry.path(), segments, segment_idx, paths);
+			}
+		}
+		return;
+	}
+	if (!segment.pattern.has_value()) {
+		// Literal segments are looked up without listing the directory
+		const auto path = dir / segment.literal;
+		if (std::filesystem::exists(path)) {
+			match_f(path, std::filesystem::is_directory(path));
+		}
+		return;
+	}
+	for (const auto& entry : std::filesystem::directory_iterator{ dir }) {
+		if (segment.pattern->matches(entry.path().filename())) {
+			match_f(entry.path(), entry.is_directory());
+		}
+	}
+}
+}
+
+
+auto peo::expand_glob(
+	const std::filesystem::path& root,
+	const std::string_view pattern
+) -> std::vector<std::filesystem::path> {
+	if (!std::filesystem::exists(root)) {
+		throw peo::exceptions::dir_not_found_exception{ root };
+	}
+	if (!std::filesystem::is_directory(root)) {
+		throw peo::exceptions::is_not_directory_exception{ root };
+	}
+	auto segments = std::vector<detail::glob_segment_t>{};
+	for (const auto& part : split_string_to_views(pattern, "/")) {
+		auto segment = detail::glob_segment_t{};
+		segment.literal = std::string{ part };
+		segment.is_globstar = part == "**";
+		if (!segment.is_globstar && part.find_first_of("*?[") != std::string_view::npos) {
+			segment.pattern.emplace(part);
+		}
+		segments.push_back(std::move(segment));
+	}
+	auto paths = std::vector<std::filesystem::path>{};
+	if (segments.empty()) {
+		return paths;
+	}
+	detail::impl_expand_glob(root, segments, 0, paths);
+	// Several globstars may reach a path in more than one way
+	std::sort(paths.begin(), paths.end());
+	paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+	return paths;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
@@ -4,16 +4,126 @@ namespace peo {
 
 [[nodiscard]] inline auto is_vector_equal_to_file_content(const detail::byte_view& bytevector, const std::filesystem::path& filepath) -> bool;
 [[nodiscard]] inline auto is_string_equal_to_file_content(std::string_view str, const std::filesystem::path& filepath) -> bool;
-template <typename Str0, typename Str1> [[nodiscard]] auto count_occurances(const Str0& haystack, const Str1& needle) noexcept -> size_t;
+template <typename Str0, typename Str1> [[nodiscard]] auto count_occurances(const Str0& haystack, const Str1& needle, bool overlapping = false) noexcept -> size_t;
+template <typename Str0, typename Str1> [[nodiscard]] auto count_occurances_parallel(const Str0& haystack, const Str1& needle, bool overlapping = false, size_t num_threads = 0) -> size_t; // num_threads = 0 utilizes all hardware threads
 template <typename Str0, typename Str1> [[nodiscard]] auto count_occurances_ignore_case(const Str0& haystack, const Str1& needle, const std::locale& loc = std::locale{}) noexcept -> size_t;
 }
 
 
+namespace peo::detail {
+// Compare results are accumulated per byte lane, which are summed before they can overflow
+[[nodiscard]] inline auto impl_count_char(
+	const char* data, 
+	const size_t size, 
+	const char c
+) noexcept -> size_t {
+	constexpr auto max_blocks_per_flush = size_t{ 255 };
+	auto count = size_t{ 0 };
+	auto i = size_t{ 0 };
+#if PRECOOKED_AVX2
+	const auto c_avx2 = _mm256_set1_epi8(c);
+	while (i + 32 <= size) {
+		auto lanes = _mm256_setzero_si256();
+		const auto num_blocks = std::min((size - i) / 32, max_blocks_per_flush);
+		for (size_t block = 0; block < num_blocks; ++block, i += 32) {
+			const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+			lanes = _mm256_sub_epi8(lanes, _mm256_cmpeq_epi8(v, c_avx2));
+		}
+		uint64_t sums[4]{};
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(sums), _mm256_sad_epu8(lanes, _mm256_setzero_si256()));
+		count += static_cast<size_t>(sums[0] + sums[1] + sums[2] + sums[3]);
+	}
+#endif
+#if PRECOOKED_SSE2
+	const auto c_sse2 = _mm_set1_epi8(c);
+	while (i + 16 <= size) {
+		auto lanes = _mm_setzero_si128();
+		const auto num_blocks = std::min((size - i) / 16, max_blocks_per_flush);
+		for (size_t block = 0; block < num_blocks; ++block, i += 16) {
+			const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+			lanes = _mm_sub_epi8(lanes, _mm_cmpeq_epi8(v, c_sse2));
+		}
+		uint64_t sums[2]{};
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(sums), _mm_sad_epu8(lanes, _mm_setzero_si128()));
+		count += static_cast<size_t>(sums[0] + sums[1]);
+	}
+#endif
+	for (; i < size; ++i) {
+		count += data[i] == c;
+	}
+	return count;
+}
+
+template <typename Char>
+[[nodiscard]] auto impl_count_occurances_of(
+	const std::basic_string_view<Char>& haystack,
+	const std::basic_string_view<Char>& needle,
+	const bool overlapping
+) noexcept -> size_t {
+	PRECOOKED_ASSERT(!needle.empty());
+	if (needle.size() == 1) {
+		if constexpr (std::is_same_v<Char, char>) {
+			return impl_count_char(haystack.data(), haystack.size(), needle.front());
+		}
+		else {
+			return static_cast<size_t>(std::count(haystack.begin(), haystack.end(), needle.front()));
+		}
+	}
+	constexpr auto npos = std::basic_string_view<Char>::npos;
+	const auto step = overlapping ? size_t{ 1 } : needle.size();
+	auto count = size_t{ 0 };
+	for (auto i = haystack.find(needle); i != npos; i = haystack.find(needle, i + step)) {
+		++count;
+	}
+	return count;
+}
+
+// A suffix of the needle is also a prefix, ie "abca" or "aa"
+template <typename Char>
+[[nodiscard]] auto is_self_overlapping(const std::basic_string_view<Char>& needle) noexcept -> bool {
+	for (size_t shift = 1; shift < needle.size(); ++shift) {
+		if (needle.substr(shift) == needle.substr(0, needle.size() - shift)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Each chunk counts the matches starting within it, which is exact unless 
+// non-overlapping matches of a self overlapping needle are counted
+template <typename Char>
+[[nodiscard]] auto impl_count_occurances_parallel(
+	const std::basic_string_view<Char>& haystack,
+	const std::basic_string_view<Char>& needle,
+	const bool overlapping,
+	const size_t num_threads
+) -> size_t {
+	PRECOOKED_ASSERT(!needle.empty());
+	PRECOOKED_ASSERT(overlapping || !is_self_overlapping(needle));
+	const auto chunk_size = std::max({
+		(haystack.size() + num_threads * 4 - 1) / (num_threads * 4),
+		parallel_min_chunk_size,
+		needle.size()
+	});
+	const auto num_chunks = (haystack.size() + chunk_size - 1) / chunk_size;
+	auto counts = std::vector<size_t>(num_chunks, 0);
+	impl_parallel_for(num_chunks, num_threads, [&](const size_t chunk) noexcept {
+		const auto chunk_begin = chunk * chunk_size;
+		const auto window_end = std::min(chunk_begin + chunk_size + needle.size() - 1, haystack.size());
+		const auto window = haystack.substr(chunk_begin, window_end - chunk_begin);
+		counts[chunk] = impl_count_occurances_of(window, needle, overlapping);
+	});
+	return std::accumulate(counts.begin(), counts.end(), size_t{ 0 });
+}
+}
+
+
 namespace peo {
 template <typename Str0, typename Str1>
 [[nodiscard]] auto count_occurances(
 	const Str0& haystack,
-	const Str1& needle
+	const Str1& needle,
+	const bool overlapping
 ) noexcept -> size_t {
 	using Char = peo::type_traits::underlying_char_t<Str0>;
 	const auto haystack_sv = std::basic_string_view<Char>{ haystack };
@@ -24,14 +134,32 @@ template <typename Str0, typename Str1>
 	) {
 		return 0;
 	}
-	return detail::impl_count_occurances(
-		haystack_sv,
-		needle_sv,
-		size_t{ 0 },
-		[](const auto& haystack, const auto& needle, const size_t offset) {
-			return haystack.find(needle, offset);
-		}
-	);
+	return detail::impl_count_occurances_of(haystack_sv, needle_sv, overlapping);
+}
+template <typename Str0, typename Str1>
+[[nodiscard]] auto count_occurances_parallel(
+	const Str0& haystack,
+	const Str1& needle,
+	const bool overlapping,
+	const size_t num_threads
+) -> size_t {
+	using Char = peo::type_traits::underlying_char_t<Str0>;
+	const auto haystack_sv = std::basic_string_view<Char>{ haystack };
+	const auto needle_sv = std::basic_string_view<Char>{ needle };
+	if (
+		haystack_sv.size() < needle_sv.size() ||
+		needle_sv.empty()
+	) {
+		return 0;
+	}
+	const auto num_threads_resolved = detail::resolve_num_threads(num_threads);
+	const auto is_parallel =
+		num_threads_resolved > 1 &&
+		haystack_sv.size() >= detail::parallel_min_size &&
+		(overlapping || !detail::is_self_overlapping(needle_sv));
+	return is_parallel ?
+		detail::impl_count_occurances_parallel(haystack_sv, needle_sv, overlapping, num_threads_resolved) :
+		detail::impl_count_occurances_of(haystack_sv, needle_sv, overlapping);
 }
 template <typename Str0, typename Str1>
 [[nodiscard]] auto count_occurances_ignore_case(
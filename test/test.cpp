@@ -5,13 +5,18 @@
 
 
 #include <iostream>
+#include <list>
 #include <map>
 #include <type_traits>
 #include <mutex>
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <string>
 #include <cstddef>
+#include <iomanip>
+#include <random>
+#include <unordered_map>
 
 
 
@@ -138,6 +143,192 @@ TEST_CASE("file_to_string"){
 
 
 
+TEST_CASE("replace_all_in_file"){
+	namespace fs = std::filesystem;
+	const auto tmpdir = fs::temp_directory_path();
+	const auto src_path = tmpdir / "test_replace_src.txt";
+	const auto dst_path = tmpdir / "test_replace_dst.txt";
+	// Spans several chunks, with needles crossing the chunk boundaries
+	auto content = std::string{};
+	for (size_t i = 0; content.size() < 3 * peo::detail::file_chunk_size; ++i) {
+		content += std::string(i % 17, '-');
+		content += "old.host";
+	}
+	for (auto&& needle : { "old.host", "o", "-old.host-", "not-present" }) {
+		for (auto&& replacement : { "new.example.host", "", "x" }) {
+			peo::write_string_to_file(content, src_path);
+			const auto num_replacements = peo::replace_all_in_file(src_path, dst_path, needle, replacement);
+			REQUIRE(peo::read_file_to_string(dst_path) == peo::replace_all(content, needle, replacement));
+			REQUIRE(num_replacements == peo::searcher{ needle }.count(content));
+		}
+	}
+	REQUIRE_THROWS(peo::replace_all_in_file(src_path, src_path, "a", "b"));
+	REQUIRE_THROWS(peo::replace_all_in_file(tmpdir / "nonexisting_file.txt", dst_path, "a", "b"));
+}
+
+
+
+
+TEST_CASE("replace_all_in_file_inplace"){
+	namespace fs = std::filesystem;
+	const auto path = fs::temp_directory_path() / "test_replace_inplace.bin";
+	auto content = std::string{};
+	for (size_t i = 0; content.size() < 3 * peo::detail::file_chunk_size; ++i) {
+		content += std::string(i % 13, '-');
+		content += "secret";
+	}
+	for (auto&& needle : { "secret", "-", "--se", "absent" }) {
+		const auto replacement = std::string(std::string_view{ needle }.size(), 'x');
+		peo::write_string_to_file(content, path);
+		const auto num_replacements = peo::replace_all_in_file_inplace(path, needle, replacement);
+		REQUIRE(peo::read_file_to_string(path) == peo::replace_all(content, needle, replacement));
+		REQUIRE(num_replacements == peo::searcher{ needle }.count(content));
+	}
+	peo::write_string_to_file("aaaaa", path);
+	REQUIRE(peo::replace_all_in_file_inplace(path, "aa", "ab") == 2);
+	REQUIRE(peo::read_file_to_string(path) == "ababa");
+	REQUIRE_THROWS(peo::replace_all_in_file_inplace(path, "a", "bb"));
+}
+
+
+
+
+// Glob
+TEST_CASE("expand_glob"){
+	namespace fs = std::filesystem;
+	const auto root = fs::temp_directory_path() / "precooked_expand_glob";
+	fs::remove_all(root);
+	for (const auto* file : { "src/a/include/x.hpp", "src/a/include/deep/y.hpp", "src/b/include/z.cpp", "src/b/other/w.hpp", "top.hpp" }) {
+		peo::write_string_to_file(std::string{ "content" }, root / file);
+	}
+	const auto relative_f = [&root](const std::vector<fs::path>& paths) {
+		auto relatives = std::vector<std::string>{};
+		for (const auto& path : paths) {
+			relatives.push_back(path.lexically_relative(root).generic_string());
+		}
+		return relatives;
+	};
+	using strings = std::vector<std::string>;
+	REQUIRE(relative_f(peo::expand_glob(root, "src/*/include/**/*.hpp")) == strings{ "src/a/include/deep/y.hpp", "src/a/include/x.hpp" });
+	REQUIRE(relative_f(peo::expand_glob(root, "**/*.hpp")) == strings{ "src/a/include/deep/y.hpp", "src/a/include/x.hpp", "src/b/other/w.hpp", "top.hpp" });
+	REQUIRE(relative_f(peo::expand_glob(root, "**/**/z.cpp")) == strings{ "src/b/include/z.cpp" });
+	REQUIRE(relative_f(peo::expand_glob(root, "src/b/**")) == strings{ "src/b/include", "src/b/include/z.cpp", "src/b/other", "src/b/other/w.hpp" });
+	REQUIRE(relative_f(peo::expand_glob(root, "src/?")) == strings{ "src/a", "src/b" });
+	REQUIRE(relative_f(peo::expand_glob(root, "top.hpp")) == strings{ "top.hpp" });
+	REQUIRE(peo::expand_glob(root, "missing/*").empty());
+	REQUIRE_THROWS_AS(peo::expand_glob(root / "missing", "*"), peo::exceptions::dir_not_found_exception);
+	fs::remove_all(root);
+}
+
+namespace {
+// Backtracking reference for glob_pattern
+auto glob_reference(const std::string_view pattern, const size_t pi, const std::string_view str, const size_t si) -> bool {
+	if (pi == pattern.size()) {
+		return si == str.size();
+	}
+	const auto rest = pattern.substr(pi);
+	const auto is_segment_begin = pi == 0 || pattern[pi - 1] == '/';
+	if (is_segment_begin && rest.substr(0, 3) == "**/") {
+		for (auto k = si; k <= str.size(); ++k) {
+			if ((k == si || str[k - 1] == '/') && glob_reference(pattern, pi + 3, str, k)) {
+				return true;
+			}
+		}
+		return false;
+	}
+	if (is_segment_begin && rest == "**") {
+		return true;
+	}
+	if (rest[0] == '*') {
+		const auto num_stars = rest.substr(0, 2) == "**" ? 2 : 1;
+		for (auto k = si; k <= str.size(); ++k) {
+			if (glob_reference(pattern, pi + num_stars, str, k)) {
+				return true;
+			}
+			if (k < str.size() && str[k] == '/') {
+				break;
+			}
+		}
+		return false;
+	}
+	if (si == str.size() || str[si] == '/') {
+		return rest[0] == '/' && si < str.size() && glob_reference(pattern, pi + 1, str, si + 1);
+	}
+	if (rest[0] == '?') {
+		return glob_reference(pattern, pi + 1, str, si + 1);
+	}
+	if (rest.substr(0, 4) == "[!a]") {
+		return str[si] != 'a' && glob_reference(pattern, pi + 4, str, si + 1);
+	}
+	if (rest.substr(0, 5) == "[a-b]") {
+		return (str[si] == 'a' || str[si] == 'b') && glob_reference(pattern, pi + 5, str, si + 1);
+	}
+	return rest[0] == str[si] && glob_reference(pattern, pi + 1, str, si + 1);
+}
+}
+
+TEST_CASE("glob_pattern"){
+	namespace fs = std::filesystem;
+	REQUIRE(peo::glob_pattern{ "*.log" }.matches("server.log"));
+	REQUIRE(!peo::glob_pattern{ "*.log" }.matches("logs/server.log"));
+	REQUIRE(!peo::glob_pattern{ "*.log" }.matches("server.LOG"));
+	REQUIRE(peo::glob_pattern_ignore_case{ "*.log" }.matches("server.LOG"));
+	REQUIRE(peo::glob_pattern{ "data_??.bin" }.matches("data_07.bin"));
+	REQUIRE(!peo::glob_pattern{ "data_??.bin" }.matches("data_7.bin"));
+	REQUIRE(peo::glob_pattern{ "**/cache/*" }.matches("cache/a"));
+	REQUIRE(peo::glob_pattern{ "**/cache/*" }.matches("x/y/cache/a"));
+	REQUIRE(!peo::glob_pattern{ "**/cache/*" }.matches("x/ycache/a"));
+	REQUIRE(!peo::glob_pattern{ "**/cache/*" }.matches("x/cache/a/b"));
+	REQUIRE(peo::glob_pattern{ "src/**" }.matches("src/a/b.cpp"));
+	REQUIRE(peo::glob_pattern{ "file[0-9].[!c]*" }.matches("file3.hpp"));
+	REQUIRE(!peo::glob_pattern{ "file[0-9].[!c]*" }.matches("file3.cpp"));
+	REQUIRE(peo::glob_pattern{ "[]]" }.matches("]"));
+	REQUIRE(peo::glob_pattern{ "a[b" }.matches("a[b"));
+	REQUIRE(peo::glob_pattern{ "" }.matches(""));
+	REQUIRE(!peo::glob_pattern{ "" }.matches("a"));
+	const auto sources = peo::glob_pattern{ std::vector<std::string>{ "*.cpp", "*.hpp", "CMakeLists.txt" } };
+	REQUIRE(sources.matches("main.cpp"));
+	REQUIRE(sources.matches("CMakeLists.txt"));
+	REQUIRE(!sources.matches("main.o"));
+	REQUIRE(sources.matches(fs::path{ "x.hpp" }));
+
+	// Compare with backtracking, for single patterns and for many patterns at once 
+	// which use more than one word of states
+	auto rng = std::mt19937{ 23 };
+	const auto tokens = std::vector<std::string_view>{ "a", "b", "/", "*", "?", "**/", "**", "[!a]", "[a-b]" };
+	const auto random_pattern_f = [&] {
+		auto pattern = std::string{};
+		for (auto n = rng() % 6; n > 0; --n) {
+			pattern += tokens[rng() % tokens.size()];
+		}
+		return pattern;
+	};
+	const auto random_string_f = [&] {
+		auto str = std::string{};
+		for (auto n = rng() % 8; n > 0; --n) {
+			str += "ab/"[rng() % 3];
+		}
+		return str;
+	};
+	for (auto iteration = 0; iteration < 300; ++iteration) {
+		auto patterns = std::vector<std::string>{};
+		for (auto n = iteration % 2 == 0 ? 1 : 30; n > 0; --n) {
+			patterns.push_back(random_pattern_f());
+		}
+		const auto glob = peo::glob_pattern{ patterns };
+		for (auto i = 0; i < 20; ++i) {
+			const auto str = random_string_f();
+			const auto facit = std::any_of(patterns.begin(), patterns.end(), [&str](const std::string& pattern) {
+				return glob_reference(pattern, 0, str, 0);
+			});
+			REQUIRE(glob.matches(str) == facit);
+		}
+	}
+}
+
+
+
+
 // Tuple
 TEST_CASE("tuple"){
 	REQUIRE(
@@ -259,6 +450,7 @@ TEST_CASE("split_string"){
 
 
 
+// Case insensitive
 TEST_CASE("find_ignore_case"){
 	using namespace std::string_view_literals;
 	const auto str = "aa01234abc"sv;
@@ -284,6 +476,284 @@ TEST_CASE("find_ignore_case"){
 }
 
 
+TEST_CASE("find_ignore_case (ascii fast path)"){
+	// The classic locale fast path must give the same results as the locale facets
+	const auto loc = std::locale::classic();
+	// Tabulated from the facets, without the ascii fast path
+	const auto folder = peo::case_folder{ loc };
+	const auto alphabet = std::string_view{ "aAbB-_zZ@[`{\x80\xc1\xe1" };
+	auto rng = std::mt19937{ 42 };
+	const auto random_string_f = [&](const size_t size) {
+		auto str = std::string{};
+		for (size_t i = 0; i < size; ++i) {
+			str += alphabet[rng() % alphabet.size()];
+		}
+		return str;
+	};
+	for (auto iteration = 0; iteration < 500; ++iteration) {
+		const auto haystack = random_string_f(rng() % 80);
+		const auto needle = random_string_f(1 + rng() % 3);
+		const auto haystack_sv = std::string_view{ haystack };
+		const auto needle_sv = std::string_view{ needle };
+		const auto offset = static_cast<size_t>(rng() % 8);
+		const auto facit = haystack.size() < needle.size() ?
+			std::string::npos :
+			peo::detail::impl_find_ignore_case_with_front(
+				haystack_sv,
+				needle_sv,
+				offset,
+				folder.to_upper(needle.front()),
+				folder.to_lower(needle.front()),
+				folder
+			);
+		REQUIRE(peo::find_ignore_case(haystack, needle, offset, loc) == facit);
+		const auto other = random_string_f(haystack.size());
+		REQUIRE(
+			peo::is_equal_ignore_case(haystack, other, loc) ==
+			peo::detail::impl_is_equal_ignore_case_folded(haystack_sv, std::string_view{ other }, folder)
+		);
+		REQUIRE(peo::is_equal_ignore_case(haystack, peo::to_upper(haystack, loc), loc));
+	}
+}
+
+
+
+namespace {
+// Folds the latin-1 letters '\xc4' and '\xe4' in addition to ASCII
+class latin1_ctype : public std::ctype<char> {
+	auto do_tolower(char c) const -> char override { 
+		return c == '\xc4' ? '\xe4' : std::ctype<char>::do_tolower(c); 
+	}
+	auto do_toupper(char c) const -> char override { 
+		return c == '\xe4' ? '\xc4' : std::ctype<char>::do_toupper(c); 
+	}
+	auto do_tolower(char* first, const char* last) const -> const char* override {
+		for (; first != last; ++first) { *first = do_tolower(*first); }
+		return last;
+	}
+	auto do_toupper(char* first, const char* last) const -> const char* override {
+		for (; first != last; ++first) { *first = do_toupper(*first); }
+		return last;
+	}
+};
+}
+
+TEST_CASE("case_folder"){
+	const auto classic = peo::case_folder{ std::locale::classic() };
+	REQUIRE(classic.is_classic());
+	REQUIRE(peo::to_lower(std::string{ "AbC\xc4" }, classic) == "abc\xc4");
+	REQUIRE(peo::to_upper(std::string_view{ "AbC\xe4" }, classic) == "ABC\xe4");
+	REQUIRE(peo::to_lower(std::wstring{ L"AbC" }, classic) == L"abc");
+	REQUIRE(peo::to_upper(std::wstring_view{ L"AbC" }, classic) == L"ABC");
+	REQUIRE(peo::find_ignore_case("abcABC", "Bc", 2, classic) == 4);
+	REQUIRE(peo::find_ignore_case(L"abcABC", L"Bc", classic) == 1);
+	REQUIRE(peo::is_equal_ignore_case(std::string{ "aBc" }, "AbC", classic));
+	REQUIRE(peo::contains_substring_ignore_case("xxABCxx", "abc", classic));
+	REQUIRE(peo::replace_all_ignore_case(std::string{ "aXbxc" }, "x", "--", classic) == "a--b--c");
+	REQUIRE(peo::replace_all_ignore_case(std::string_view{ "aXbxc" }, "x", "", classic) == "abc");
+	REQUIRE(peo::is_trimmed("a b", classic));
+	REQUIRE(!peo::is_trimmed(L" a", classic));
+	REQUIRE(peo::trim_string(std::string{ "\t a \n" }, classic) == "a");
+	REQUIRE(peo::trim_string_to_view(std::string_view{ " a " }, classic) == "a");
+
+	const auto latin1_loc = std::locale{ std::locale::classic(), new latin1_ctype{} };
+	const auto latin1 = peo::case_folder{ latin1_loc };
+	REQUIRE(!latin1.is_classic());
+	REQUIRE(peo::to_lower(std::string{ "A\xc4" }, latin1) == "a\xe4");
+	REQUIRE(peo::to_upper(std::string_view{ "a\xe4" }, latin1) == "A\xc4");
+	REQUIRE(peo::is_equal_ignore_case("x\xc4", "X\xe4", latin1));
+	REQUIRE(peo::is_equal_ignore_case("x\xc4", "X\xe4", latin1_loc));
+	REQUIRE(!peo::is_equal_ignore_case("x\xc4", "X\xe4", classic));
+	REQUIRE(peo::find_ignore_case("abc\xe4\xc4", "\xc4\xe4", latin1) == 3);
+	REQUIRE(peo::replace_all_ignore_case(std::string{ "\xe4-\xc4" }, "\xc4", "a", latin1) == "a-a");
+	const auto searcher = peo::searcher_ignore_case{ std::string_view{ "x\xe4yz" }, latin1 };
+	REQUIRE(searcher.find("__X\xc4YZ") == 2);
+}
+
+TEST_CASE("to_lower and to_upper (ascii blocks)"){
+	// Block-wise folding must match folding char by char, on all sizes and alignments
+	const auto alphabet = std::string_view{ "aAzZ@[`{0 \x80\xc4\xe4\xff" };
+	const auto classic = peo::case_folder{ std::locale::classic() };
+	const auto latin1 = peo::case_folder{ std::locale{ std::locale::classic(), new latin1_ctype{} } };
+	REQUIRE(latin1.is_ascii_compatible());
+	auto rng = std::mt19937{ 7 };
+	for (auto iteration = 0; iteration < 300; ++iteration) {
+		const auto size = static_cast<size_t>(rng() % 100);
+		const auto is_ascii_only = iteration % 2 == 0;
+		auto str = std::string{};
+		for (size_t i = 0; i < size; ++i) {
+			str += alphabet[rng() % (is_ascii_only ? 10 : alphabet.size())];
+		}
+		const auto offset = std::min(size, static_cast<size_t>(rng() % 4));
+		const auto sv = std::string_view{ str }.substr(offset);
+		for (const auto* folder : { &classic, &latin1 }) {
+			auto lower = std::string{};
+			auto upper = std::string{};
+			for (const auto c : sv) {
+				lower += folder->to_lower(c);
+				upper += folder->to_upper(c);
+			}
+			REQUIRE(peo::to_lower(sv, *folder) == lower);
+			REQUIRE(peo::to_upper(sv, *folder) == upper);
+			REQUIRE(peo::to_lower(std::string{ sv }, *folder) == lower);
+			REQUIRE(peo::to_upper(std::string{ sv }, *folder) == upper);
+		}
+		REQUIRE(peo::to_lower(sv, std::locale::classic()) == peo::to_lower(sv, classic));
+	}
+	// Rvalues are folded in place
+	auto str = std::string(100, 'A');
+	const auto* data = static_cast<const void*>(str.data());
+	str = peo::to_lower(std::move(str));
+	REQUIRE(static_cast<const void*>(str.data()) == data);
+	REQUIRE(str == std::string(100, 'a'));
+}
+
+TEST_CASE("utf8 case folding"){
+	// Ä, Σ, Ⱥ (two bytes, lowercase is three bytes) and the Kelvin sign
+	const auto A_umlaut = std::string{ "\xc3\x84" };
+	const auto a_umlaut = std::string{ "\xc3\xa4" };
+	const auto Sigma = std::string{ "\xce\xa3" };
+	const auto sigma = std::string{ "\xcf\x83" };
+	const auto final_sigma = std::string{ "\xcf\x82" };
+	const auto A_stroke = std::string{ "\xc8\xba" };
+	const auto a_stroke = std::string{ "\xe2\xb1\xa5" };
+	const auto kelvin = std::string{ "\xe2\x84\xaa" };
+	REQUIRE(peo::utf8::to_lower("HELLO " + A_umlaut + Sigma) == "hello " + a_umlaut + sigma);
+	REQUIRE(peo::utf8::to_lower(A_stroke + "X") == a_stroke + "x");
+	REQUIRE(peo::utf8::to_lower("A\xff\xc3" "B") == "a\xff\xc3" "b");
+	REQUIRE(peo::utf8::to_lower(std::string(100, 'A') + A_umlaut + std::string(50, 'B')) == std::string(100, 'a') + a_umlaut + std::string(50, 'b'));
+
+	REQUIRE(peo::utf8::is_equal_ignore_case(Sigma + "A" + Sigma, sigma + "a" + final_sigma));
+	REQUIRE(peo::utf8::is_equal_ignore_case(A_stroke, a_stroke));
+	REQUIRE(peo::utf8::is_equal_ignore_case(kelvin, "k"));
+	REQUIRE(peo::utf8::is_equal_ignore_case(std::string(40, 'x') + A_umlaut, std::string(40, 'X') + a_umlaut));
+	REQUIRE(!peo::utf8::is_equal_ignore_case(std::string(40, 'x') + A_umlaut, std::string(40, 'X') + a_umlaut + "!"));
+	REQUIRE(!peo::utf8::is_equal_ignore_case("Stra\xc3\x9f" "e", "STRASSE"));
+	REQUIRE(peo::utf8::is_equal_ignore_case("\xff", "\xff"));
+	REQUIRE(!peo::utf8::is_equal_ignore_case("\xff", "\xfe"));
+
+	REQUIRE(peo::utf8::find_ignore_case(std::string(40, 'x') + A_umlaut + "BC", a_umlaut + "b") == 40);
+	REQUIRE(peo::utf8::find_ignore_case(std::string(40, 'x') + kelvin + "!", "K!") == 40);
+	REQUIRE(peo::utf8::find_ignore_case(std::string(40, 'x') + "Yz", "yZ") == 40);
+	REQUIRE(peo::utf8::find_ignore_case(std::string(40, 'x') + "Yz", "yZ", 41) == std::string::npos);
+	REQUIRE(peo::utf8::find_ignore_case("abc", "") == std::string::npos);
+
+	// Block skipping must find the same first match as testing every code point
+	const auto alphabet = std::vector<std::string>{ "a", "B", "k", A_umlaut, a_umlaut, Sigma, sigma, kelvin, A_stroke, "\xff" };
+	auto rng = std::mt19937{ 3 };
+	const auto random_string_f = [&](const size_t num_chars, const bool is_mostly_ascii) {
+		auto str = std::string{};
+		for (size_t i = 0; i < num_chars; ++i) {
+			const auto idx = rng() % alphabet.size();
+			str += is_mostly_ascii && rng() % 16 != 0 ? alphabet[idx % 3] : alphabet[idx];
+		}
+		return str;
+	};
+	for (auto iteration = 0; iteration < 500; ++iteration) {
+		const auto haystack = random_string_f(rng() % 120, iteration % 2 == 0);
+		const auto needle = random_string_f(1 + rng() % 3, false);
+		auto facit = std::string::npos;
+		for (size_t i = 0; i < haystack.size();) {
+			if (peo::detail::utf8_is_match_ignore_case_at(haystack, i, needle)) {
+				facit = i;
+				break;
+			}
+			auto cp = char32_t{};
+			i += peo::detail::utf8_decode(haystack.data() + i, haystack.data() + haystack.size(), cp);
+		}
+		REQUIRE(peo::utf8::find_ignore_case(haystack, needle) == facit);
+		REQUIRE(peo::utf8::is_equal_ignore_case(haystack, peo::utf8::to_lower(haystack)));
+	}
+}
+
+TEST_CASE("hash_ignore_case and equal_ignore_case"){
+	const auto hash = peo::hash_ignore_case{};
+	const auto equal = peo::equal_ignore_case{};
+	REQUIRE(hash(std::string{ "Content-Length" }) == hash("content-length"));
+	REQUIRE(hash(std::string_view{ "CONTENT-LENGTH-AND-MORE" }) == hash("content-length-and-more"));
+	REQUIRE(hash(L"Content-Type") == hash(std::wstring{ L"CONTENT-TYPE" }));
+	REQUIRE(hash("a") != hash(std::string_view{ "a\0", 2 }));
+	REQUIRE(hash("\xc4") != hash("\xe4"));
+	REQUIRE(equal("Content-Length", std::string{ "CONTENT-length" }));
+	REQUIRE(!equal("Content-Length", "Content-Lengths"));
+	REQUIRE(!equal("[", "{"));
+	REQUIRE(equal(L"Host", L"hOST"));
+	// All chars, the ASCII letters only differ by case
+	for (auto a = 0; a < 256; ++a) {
+		for (auto b = 0; b < 256; ++b) {
+			const auto a_str = std::string(9, static_cast<char>(a));
+			const auto b_str = std::string(9, static_cast<char>(b));
+			const auto facit = 
+				a == b || 
+				(std::isalpha(a) && std::isalpha(b) && (a | 0x20) == (b | 0x20));
+			REQUIRE(equal(a_str, b_str) == facit);
+			if (facit) {
+				REQUIRE(hash(a_str) == hash(b_str));
+			}
+		}
+	}
+	auto map = std::unordered_map<std::string, int, peo::hash_ignore_case, peo::equal_ignore_case>{};
+	map["Accept"] = 1;
+	REQUIRE(map.count("ACCEPT") == 1);
+}
+
+TEST_CASE("flat_map_ignore_case"){
+	auto map = peo::flat_map_ignore_case<int>{ { "Accept", 1 }, { "Host", 2 } };
+	REQUIRE(map.size() == 2);
+	REQUIRE(map.at("ACCEPT") == 1);
+	REQUIRE(map.contains(std::string{ "host" }));
+	REQUIRE(!map.contains("hosts"));
+	REQUIRE_THROWS_AS(map.at("missing"), std::out_of_range);
+	map["CONTENT-TYPE"] = 3;
+	REQUIRE(map.find("content-type")->first == "CONTENT-TYPE");
+	REQUIRE(!map.try_emplace("Content-Type", 4).second);
+	REQUIRE(map.at("content-type") == 3);
+	REQUIRE(!map.insert_or_assign("Content-Type", 5).second);
+	REQUIRE(map.at("content-type") == 5);
+	REQUIRE(map.erase("accept") == 1);
+	REQUIRE(map.erase("accept") == 0);
+	REQUIRE(map.size() == 2);
+	REQUIRE(map.at("HOST") == 2);
+
+	// Compare against std::map on random inserts and erases, with forced collisions from a small key space
+	auto facit = std::map<std::string, int>{};
+	auto rng = std::mt19937{ 11 };
+	const auto random_key_f = [&] {
+		auto key = std::string{ "key" };
+		key += std::to_string(rng() % 300);
+		if (rng() % 2 == 0) {
+			key = peo::to_upper(key);
+		}
+		return key;
+	};
+	auto random_map = peo::flat_map_ignore_case<int>{};
+	for (auto iteration = 0; iteration < 20000; ++iteration) {
+		const auto key = random_key_f();
+		const auto lower_key = peo::to_lower(key);
+		if (rng() % 3 == 0) {
+			REQUIRE(random_map.erase(key) == facit.erase(lower_key));
+		}
+		else {
+			random_map[key] = iteration;
+			facit[lower_key] = iteration;
+		}
+		REQUIRE(random_map.size() == facit.size());
+	}
+	for (const auto& [key, value] : facit) {
+		REQUIRE(random_map.at(key) == value);
+	}
+	auto num_visited = size_t{ 0 };
+	for (const auto& [key, value] : random_map) {
+		REQUIRE(facit.at(peo::to_lower(key)) == value);
+		++num_visited;
+	}
+	REQUIRE(num_visited == facit.size());
+	while (!random_map.empty()) {
+		random_map.erase(random_map.begin());
+	}
+}
+
+
 
 
 // String trim
@@ -331,6 +801,105 @@ TEST_CASE("trim_string"){
 }
 
 
+TEST_CASE("char_set"){
+	constexpr auto spaces = peo::char_set{ " \t\r\n" };
+	static_assert(spaces.contains(' ') && spaces.contains('\n') && !spaces.contains('a'));
+	{
+		const auto set = peo::char_set{ "\x80\xff-" };
+		for (int i = 0; i < 256; ++i) {
+			const auto c = static_cast<char>(i);
+			REQUIRE(set.contains(c) == (c == '\x80' || c == '\xff' || c == '-'));
+		}
+	}
+	{
+		auto wide_set = peo::basic_char_set{ L" \x3000" };
+		REQUIRE(wide_set.contains(L'\x3000'));
+		REQUIRE(!wide_set.contains(L'\x2000'));
+	}
+	// Compare against the string overloads, long enough for the SIMD blocks
+	const auto trim_chars = std::string{ " \t-\xe4" };
+	const auto set = peo::char_set{ trim_chars };
+	const auto pad_f = [](size_t size, char c) { return std::string(size, c); };
+	for (const auto num_pads : { size_t{ 0 }, size_t{ 1 }, size_t{ 15 }, size_t{ 16 }, size_t{ 17 }, size_t{ 40 } }) {
+		for (const auto& body : { std::string{}, std::string{ "a" }, std::string{ "a - b\xe4" "c" } + pad_f(num_pads, 'x') }) {
+			const auto str = pad_f(num_pads, ' ') + "\t-" + body + "\xe4" + pad_f(num_pads, '-');
+			REQUIRE(peo::trim_string_to_view(str, set) == peo::trim_string_to_view(str, trim_chars));
+			REQUIRE(peo::trim_string(str, set) == peo::trim_string(str, trim_chars));
+			REQUIRE(peo::is_trimmed(str, set) == peo::is_trimmed(str, trim_chars));
+			REQUIRE(peo::is_trimmed(body, set) == peo::is_trimmed(body, trim_chars));
+			REQUIRE(peo::split_string(str, set) == peo::split_string(str, trim_chars));
+			REQUIRE(peo::split_string_to_views(str, set) == peo::split_string_to_views(str, trim_chars));
+		}
+	}
+	REQUIRE(peo::split_string(std::string{ "a,b;;c" }, peo::char_set{ ",;" }) == std::vector<std::string>{ "a", "b", "c" });
+	REQUIRE(peo::split_string(std::wstring{ L"a\x3000" L"b c" }, peo::basic_char_set{ L" \x3000" }) == std::vector<std::wstring>{ L"a", L"b", L"c" });
+	REQUIRE(peo::trim_string(std::u32string{ U"\U0001F600a\U0001F600" }, peo::basic_char_set{ U"\U0001F600" }) == U"a");
+	REQUIRE(peo::split_string_to_lines(std::string{ "a\r\nb\n\nc" }) == std::vector<std::string>{ "a", "b", "c" });
+	{
+		auto wide_set = peo::basic_char_set<char32_t>{};
+		for (auto i = size_t{ 0 }; i < peo::basic_char_set<char32_t>::max_num_wide_chars; ++i) {
+			wide_set.insert(static_cast<char32_t>(0x1000 + i));
+		}
+		wide_set.insert(U'\x1000');
+		REQUIRE_THROWS_AS(wide_set.insert(U'\x2000'), std::length_error);
+	}
+}
+
+TEST_CASE("trim_all"){
+	const auto strs = std::vector<std::string>{
+		"", " ", "a", " a b ", "\t\r\n\v\fa\f", std::string(40, ' ') + "a" + std::string(17, '\t'),
+		std::string(16, ' '), std::string(33, ' ') + std::string(20, 'b') + std::string(16, ' '), "\xa0" "a\xa0",
+	};
+	{
+		auto trimmed = strs;
+		peo::trim_all(trimmed);
+		auto views = std::vector<std::string_view>(strs.begin(), strs.end());
+		peo::trim_all(views);
+		for (size_t i = 0; i < strs.size(); ++i) {
+			REQUIRE(trimmed[i] == peo::trim_string(strs[i]));
+			REQUIRE(views[i] == peo::trim_string_to_view(strs[i]));
+		}
+	}
+	{
+		const auto set = peo::char_set{ " a" };
+		auto trimmed = strs;
+		peo::trim_all(trimmed, set);
+		for (size_t i = 0; i < strs.size(); ++i) {
+			REQUIRE(trimmed[i] == peo::trim_string(strs[i], " a"));
+		}
+	}
+	{
+		// Spaces of a non-classic locale are tabulated
+		const auto loc = std::locale{ std::locale::classic(), new latin1_ctype{} };
+		auto trimmed = strs;
+		peo::trim_all(trimmed, loc);
+		REQUIRE(trimmed.back() == "\xa0" "a\xa0");
+		for (size_t i = 0; i < strs.size(); ++i) {
+			REQUIRE(trimmed[i] == peo::trim_string(strs[i], loc));
+		}
+	}
+	{
+		auto wide = std::vector<std::wstring>{ L" a ", L"\t\tb", L"" };
+		peo::trim_all(wide);
+		REQUIRE(wide == std::vector<std::wstring>{ L"a", L"b", L"" });
+	}
+	{
+		auto many = std::vector<std::string>{};
+		for (size_t i = 0; i < peo::detail::parallel_min_size + 5; ++i) {
+			many.push_back(std::string(i % 3, ' ') + std::to_string(i) + std::string(i % 5, '\n'));
+		}
+		auto views = std::vector<std::string_view>(many.begin(), many.end());
+		peo::trim_all_parallel(views, std::locale{}, 4);
+		for (size_t i = 0; i < views.size(); ++i) {
+			REQUIRE(views[i] == std::to_string(i));
+		}
+		peo::trim_all_parallel(many, peo::char_set{ " \n" }, 4);
+		for (size_t i = 0; i < many.size(); ++i) {
+			REQUIRE(many[i] == std::to_string(i));
+		}
+	}
+}
+
 
 // String to number
 TEST_CASE("string_to_number"){
@@ -347,6 +916,181 @@ TEST_CASE("string_to_number"){
 	REQUIRE(peo::string_to_number<double>("1  a") == std::nullopt);
 	REQUIRE(peo::string_to_number<double>("a1.5") == std::nullopt);
 	REQUIRE(peo::string_to_number<double>("abc") == std::nullopt);
+
+	// Integers agree with std::from_chars
+	const auto from_chars_f = [](const std::string_view str, auto value) -> std::optional<decltype(value)> {
+		const auto result = std::from_chars(str.data(), str.data() + str.size(), value);
+		return result.ec == std::errc{} && result.ptr == str.data() + str.size() ? value : std::optional<decltype(value)>{};
+	};
+	for (const auto* str : { 
+		"", "-", "+1", " 1", "1 ", "0", "-0", "0000000000000000000000000001", "12345678", "123456789", "1234567812345678", 
+		"2147483647", "2147483648", "-2147483648", "-2147483649", "4294967295", "4294967296", 
+		"9223372036854775807", "9223372036854775808", "-9223372036854775808", "-9223372036854775809", 
+		"18446744073709551615", "18446744073709551616", "19999999999999999999", "100000000000000000000", "1234567a", "12345678a9",
+	}) {
+		REQUIRE(peo::string_to_number<int32_t>(str) == from_chars_f(str, int32_t{}));
+		REQUIRE(peo::string_to_number<uint32_t>(str) == from_chars_f(str, uint32_t{}));
+		REQUIRE(peo::string_to_number<int64_t>(str) == from_chars_f(str, int64_t{}));
+		REQUIRE(peo::string_to_number<uint64_t>(str) == from_chars_f(str, uint64_t{}));
+		REQUIRE(peo::string_to_number<int8_t>(str) == from_chars_f(str, int8_t{}));
+		REQUIRE(peo::string_to_number<unsigned char>(str) == from_chars_f(str, static_cast<unsigned char>(0)));
+	}
+	// A default constructed view has a null data pointer
+	REQUIRE(!peo::string_to_number<int>(std::string_view{}));
+	REQUIRE(!peo::string_to_number<uint64_t>(std::string_view{}));
+}
+
+TEST_CASE("number_to_chars"){
+	using namespace std::string_view_literals;
+	REQUIRE(peo::number_to_string(0.1) == "0.1");
+	REQUIRE(peo::number_to_string(-1234) == "-1234");
+	REQUIRE(peo::number_to_string<wchar_t>(1.5f) == L"1.5");
+	REQUIRE(peo::number_to_string<char16_t>(uint64_t{ 18446744073709551615u }) == u"18446744073709551615");
+	REQUIRE(peo::number_to_string<char32_t>(-2.5e-300) == U"-2.5e-300");
+	REQUIRE(peo::number_to_string(true) == "1");
+	const auto round_trip_f = [](const double value) {
+		return peo::string_to_number<double>(peo::number_to_string(value)) == value;
+	};
+	REQUIRE(round_trip_f(1.0 / 3.0));
+	REQUIRE(round_trip_f(std::numeric_limits<double>::max()));
+	REQUIRE(round_trip_f(std::numeric_limits<double>::denorm_min()));
+	{
+		auto buffer = std::array<char16_t, 8>{};
+		auto* end = peo::number_to_chars(buffer.data(), buffer.data() + buffer.size(), 1234567);
+		REQUIRE(std::u16string_view{ buffer.data(), static_cast<size_t>(end - buffer.data()) } == u"1234567"sv);
+		REQUIRE(peo::number_to_chars(buffer.data(), buffer.data() + 3, 1234) == nullptr);
+		end = peo::number_to_chars(buffer.data(), buffer.data() + buffer.size(), 0.5, std::chars_format::fixed, 3);
+		REQUIRE(std::u16string_view{ buffer.data(), static_cast<size_t>(end - buffer.data()) } == u"0.500"sv);
+	}
+	{
+		auto buffer = std::array<char32_t, 400>{};
+		auto* end = peo::number_to_chars(buffer.data(), buffer.data() + buffer.size(), 1e300, std::chars_format::fixed);
+		REQUIRE(static_cast<size_t>(end - buffer.data()) == 301);
+		REQUIRE(std::all_of(buffer.data() + 1, end, [](char32_t c) { return c >= U'0' && c <= U'9'; }));
+		auto narrow = std::array<char, 8>{};
+		REQUIRE(peo::number_to_chars(narrow.data(), narrow.data() + narrow.size(), 1e300, std::chars_format::fixed) == nullptr);
+		auto* narrow_end = peo::number_to_chars(narrow.data(), narrow.data() + narrow.size(), 1e300, std::chars_format::scientific);
+		REQUIRE(std::string_view{ narrow.data(), static_cast<size_t>(narrow_end - narrow.data()) } == "1e+300");
+	}
+}
+
+namespace {
+// Tokens near the edges of the integer and floating point parsers
+auto number_tokens() -> std::vector<std::string> {
+	auto tokens = std::vector<std::string>{
+		"0", "-0", "00", "007", "1", "-1", "+1", "-", ".", "1.", ".5", "-.5", "1e", "1e+", "1e5", "1E-5", "2.5e-3",
+		"127", "128", "-128", "-129", "255", "256", "65535", "-32768", "2147483647", "2147483648", "-2147483648", "-2147483649",
+		"4294967295", "4294967296", "9223372036854775807", "9223372036854775808", "-9223372036854775808", "-9223372036854775809",
+		"18446744073709551615", "18446744073709551616", "99999999999999999999", "000000000000000000000000018446744073709551615",
+		"12345678", "123456789", "1234567890123456", "12345678901234567890", "0.1", "0.3", "3.14159265358979323846", "1e22", "1e23",
+		"9007199254740992", "9007199254740993", "16777216", "16777217", "1.7976931348623157e308", "1e309", "4.9e-324", "1e-400",
+		"0.000000000000000000000000000001", "123456789012345678901234567890", "inf", "-inf", "nan", "1x", "x1", "1.2.3", "0x10",
+		"3.4028235e38", "1e39", "1e-46", "123.456e-7", "98765.4321", "1_000",
+	};
+	auto rng = std::mt19937{ 5 };
+	for (int i = 0; i < 2000; ++i) {
+		auto token = std::string{};
+		if (rng() % 4 == 0) {
+			token += '-';
+		}
+		const auto num_digits = 1 + rng() % 24;
+		for (size_t j = 0; j < num_digits; ++j) {
+			token += static_cast<char>('0' + rng() % 10);
+		}
+		if (rng() % 2 == 0) {
+			token.insert(rng() % token.size() + 1, 1, '.');
+		}
+		if (rng() % 4 == 0) {
+			token += "e" + std::to_string(static_cast<int>(rng() % 60) - 30);
+		}
+		tokens.push_back(token);
+	}
+	return tokens;
+}
+
+template <typename T>
+auto check_parse_numbers(const std::vector<std::string>& tokens, const std::string& delimiter) -> bool {
+	const auto text = peo::join_strings(tokens, delimiter);
+	auto expected = std::vector<T>{};
+	auto expected_invalid_offset = std::string_view::npos;
+	auto offset = size_t{ 0 };
+	for (const auto& token : tokens) {
+		const auto parsed = peo::string_to_number<T>(token);
+		if (!parsed) {
+			expected_invalid_offset = offset;
+			break;
+		}
+		expected.push_back(*parsed);
+		offset += token.size() + delimiter.size();
+	}
+	const auto result = peo::parse_numbers<T>(text, delimiter);
+	const auto is_equal_f = [](const T& a, const T& b) {
+		if constexpr (std::is_floating_point_v<T>) {
+			return (a == b && std::signbit(a) == std::signbit(b)) || (a != a && b != b);
+		}
+		else {
+			return a == b;
+		}
+	};
+	return
+		result.invalid_offset == expected_invalid_offset &&
+		std::equal(result.numbers.begin(), result.numbers.end(), expected.begin(), expected.end(), is_equal_f);
+}
+}
+
+TEST_CASE("parse_numbers"){
+	{
+		const auto result = peo::parse_numbers<int>(" 1, -22,,333 ,4444\n", ", \n");
+		REQUIRE(result.numbers == std::vector<int>{ 1, -22, 333, 4444 });
+		REQUIRE(result.invalid_offset == std::string_view::npos);
+	}
+	{
+		const auto result = peo::parse_numbers<int>("1,2,x3,4", ",");
+		REQUIRE(result.numbers == std::vector<int>{ 1, 2 });
+		REQUIRE(result.invalid_offset == 4);
+		REQUIRE(peo::parse_numbers<int>("1,2,3x,4", ",").invalid_offset == 4);
+		REQUIRE(peo::parse_numbers<uint8_t>("255 256", " ").invalid_offset == 4);
+		REQUIRE(peo::parse_numbers<double>("", ",").numbers.empty());
+	}
+	{
+		// Delimiters which are number chars
+		REQUIRE(peo::parse_numbers<double>("1.5.25", ".").numbers == std::vector<double>{ 1, 5, 25 });
+		REQUIRE(peo::parse_numbers<int>("1-2--3", "-").numbers == std::vector<int>{ 1, 2, 3 });
+		REQUIRE(peo::parse_numbers<double>("1e5e2", "e").numbers == std::vector<double>{ 1, 5, 2 });
+	}
+	{
+		auto buffer = std::array<int, 3>{};
+		const auto full = peo::parse_numbers_into("10 20 30 40", " ", buffer.data(), buffer.size());
+		REQUIRE(full.num_parsed == 3);
+		REQUIRE(full.offset == 9);
+		REQUIRE(!full.is_invalid);
+		REQUIRE(buffer == std::array<int, 3>{ 10, 20, 30 });
+		const auto invalid = peo::parse_numbers_into("10 2a", peo::char_set{ " " }, buffer.data(), buffer.size());
+		REQUIRE(invalid.num_parsed == 1);
+		REQUIRE(invalid.offset == 3);
+		REQUIRE(invalid.is_invalid);
+		const auto complete = peo::parse_numbers_into("7 8 ", " ", buffer.data(), buffer.size());
+		REQUIRE(complete.num_parsed == 2);
+		REQUIRE(complete.offset == 4);
+		REQUIRE(!complete.is_invalid);
+	}
+	// Every token is checked individually, and all of them together stopping at the first invalid
+	const auto tokens = number_tokens();
+	for (const auto& token : tokens) {
+		const auto single = std::vector<std::string>{ token, "1" };
+		REQUIRE(check_parse_numbers<int8_t>(single, ","));
+		REQUIRE(check_parse_numbers<uint8_t>(single, ","));
+		REQUIRE(check_parse_numbers<int16_t>(single, ","));
+		REQUIRE(check_parse_numbers<int32_t>(single, ","));
+		REQUIRE(check_parse_numbers<uint32_t>(single, ","));
+		REQUIRE(check_parse_numbers<int64_t>(single, ","));
+		REQUIRE(check_parse_numbers<uint64_t>(single, ","));
+		REQUIRE(check_parse_numbers<float>(single, ","));
+		REQUIRE(check_parse_numbers<double>(single, ","));
+		REQUIRE(check_parse_numbers<long double>(single, ","));
+	}
+	REQUIRE(check_parse_numbers<double>(tokens, " "));
+	REQUIRE(check_parse_numbers<int64_t>(tokens, "\t"));
 }
 
 TEST_CASE("replace_all_ignore_case") {
@@ -416,6 +1160,129 @@ TEST_CASE("replace_all (std::string)"){
 	);
 }
 
+TEST_CASE("replace_all (match densities)") {
+	// Covers both buffered and extrapolated sizing of the rebuilt string
+	const auto naive_replace_all_f = [](const std::string& haystack, const std::string& needle, const std::string& replacement) {
+		auto ret = std::string{};
+		for (size_t i = 0; i < haystack.size();) {
+			if (haystack.compare(i, needle.size(), needle) == 0) {
+				ret += replacement;
+				i += needle.size();
+			}
+			else {
+				ret += haystack[i];
+				++i;
+			}
+		}
+		return ret;
+	};
+	for (auto&& period : { 1, 2, 3, 7, 50 }) {
+		for (auto&& num_periods : { 1, 10, 63, 64, 65, 200, 1000 }) {
+			auto haystack = std::string{};
+			for (auto i = 0; i < num_periods; ++i) {
+				haystack += "ab";
+				haystack += std::string(static_cast<size_t>(period), '-');
+			}
+			for (auto&& replacement : { "", "x", "xyz", "0123456789" }) {
+				REQUIRE(
+					peo::replace_all(std::string_view{ haystack }, "ab", replacement) ==
+					naive_replace_all_f(haystack, "ab", replacement)
+				);
+				REQUIRE(
+					peo::replace_all(haystack, "ab", replacement) ==
+					naive_replace_all_f(haystack, "ab", replacement)
+				);
+			}
+		}
+	}
+}
+
+TEST_CASE("replace_all (grow in place)") {
+	for (auto&& num_matches : { 1, 64, 65, 500 }) {
+		auto haystack = std::string{};
+		auto facit = std::string{};
+		for (auto i = 0; i < num_matches; ++i) {
+			haystack += "-ab-";
+			facit += "-xyz-";
+		}
+		haystack.reserve(facit.size() + 32); // Avoid small string optimization
+		const auto* data = static_cast<const void*>(haystack.data());
+		const auto replaced = peo::replace_all(std::move(haystack), "ab", "xyz");
+		REQUIRE(replaced == facit);
+		REQUIRE(static_cast<const void*>(replaced.data()) == data);
+	}
+	REQUIRE(
+		peo::replace_all_ignore_case(std::string{ "aAbAA" }, "aa", "123") ==
+		"123b123"
+	);
+}
+
+TEST_CASE("replace_all_parallel") {
+	using namespace std::string_view_literals;
+	// Runs of 'a' cross the chunk boundaries, which requires resynchronization for "aa"
+	auto haystack = std::string{};
+	for (size_t i = 0; haystack.size() < 4 * peo::detail::parallel_min_size; ++i) {
+		haystack += std::string(i % 97, 'a');
+		haystack += "b";
+	}
+	for (auto&& needle : { "aa", "aaa", "ab", "b", "abaa", "c" }) {
+		for (auto&& replacement : { "", "x", "xyz" }) {
+			for (auto&& num_threads : { 0, 1, 3, 8 }) {
+				REQUIRE(
+					peo::replace_all_parallel(haystack, needle, replacement, num_threads) ==
+					peo::replace_all(haystack, needle, replacement)
+				);
+			}
+		}
+	}
+	REQUIRE(peo::replace_all_parallel("abcabc", "b", "xx") == "axxcaxxc");
+
+	// Chunks only search their own window, absent and sparse needles don't rescan the tail
+	const auto haystack_size = 4 * peo::detail::parallel_min_size;
+	for (auto&& period : { haystack_size, peo::detail::parallel_min_chunk_size / 3 }) {
+		auto sparse = std::string(haystack_size, '-');
+		for (size_t i = period; i + 2 <= sparse.size(); i += period) {
+			sparse[i] = 'a';
+			sparse[i + 1] = 'b';
+		}
+		auto num_scanned = std::atomic<size_t>{ 0 };
+		const auto counting_find_f = [&num_scanned](const std::string_view& str, const std::string_view& needle, const size_t offset) {
+			const auto match = str.find(needle, offset);
+			const auto end = match == std::string_view::npos ? str.size() : match + needle.size();
+			num_scanned += end - offset;
+			return match;
+		};
+		for (auto&& num_threads : { size_t{ 2 }, size_t{ 8 }, size_t{ 32 } }) {
+			num_scanned = 0;
+			const auto replaced = peo::detail::impl_replace_all_parallel(
+				std::string_view{ sparse }, "ab"sv, "x"sv, counting_find_f, num_threads
+			);
+			REQUIRE(replaced == peo::replace_all(sparse, "ab", "x"));
+			REQUIRE(num_scanned <= 2 * sparse.size());
+		}
+	}
+}
+
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE("replace_all (benchmark match densities)", "[!benchmark]") {
+	constexpr auto haystack_size = size_t{ 1 } << 22;
+	for (auto&& period : { size_t{ 4 }, size_t{ 64 }, size_t{ 4096 }, haystack_size }) {
+		auto haystack = std::string(haystack_size, '-');
+		for (size_t i = 0; i + 2 <= haystack.size(); i += period) {
+			haystack[i] = 'a';
+			haystack[i + 1] = 'b';
+		}
+		const auto suffix = " [1 match per " + std::to_string(period) + " chars]";
+		BENCHMARK("grow" + suffix) {
+			return peo::replace_all(std::string_view{ haystack }, "ab", "0123456789");
+		};
+		BENCHMARK("shrink" + suffix) {
+			return peo::replace_all(std::string_view{ haystack }, "ab", "x");
+		};
+	}
+}
+#endif
+
 TEST_CASE("replace_all (const char*)") {
 	REQUIRE(
 		peo::replace_all("abcabcb", "b", "dd") ==
@@ -456,6 +1323,134 @@ TEST_CASE("replace_all (const char*)") {
 
 
 
+TEST_CASE("searcher"){
+	using namespace std::string_literals;
+	using namespace std::string_view_literals;
+	const auto haystack = "abcabcab-xyzxyzabcd abcd"sv;
+	for (auto&& needle : { "abcd"sv, "abc"sv, "a"sv, "xyzxyz"sv, "zzzz"sv, "b-xyzx"sv }) {
+		const auto searcher = peo::searcher{ needle };
+		for (size_t i = 0; i < haystack.size() + 2; ++i) {
+			REQUIRE(searcher.find(haystack, i) == haystack.find(needle, i));
+		}
+		REQUIRE(searcher.contains(haystack) == peo::contains_substring(haystack, needle));
+		const auto positions = searcher.find_all(haystack);
+		REQUIRE(searcher.count(haystack) == positions.size());
+		for (auto&& pos : positions) {
+			REQUIRE(haystack.substr(pos, needle.size()) == needle);
+		}
+		REQUIRE(
+			peo::replace_all(haystack, searcher, "-") ==
+			peo::replace_all(haystack, needle, "-")
+		);
+		REQUIRE(
+			peo::replace_all(std::string{ haystack }, searcher, "0123456") ==
+			peo::replace_all(std::string{ haystack }, needle, "0123456")
+		);
+	}
+	REQUIRE(
+		peo::searcher{ "abcd"sv }.find_all("abcdabcd_abcd") ==
+		std::vector<size_t>{ 0, 4, 9 }
+	);
+	REQUIRE(peo::searcher{ "aa" }.count("aaaaa") == 2);
+	REQUIRE(peo::searcher{ "" }.count("aaaaa") == 0);
+	REQUIRE_FALSE(peo::searcher{ "" }.contains("aaaaa"));
+	REQUIRE(peo::searcher{ U"bcde"s }.find(U"abcdef") == 1);
+}
+
+TEST_CASE("searcher_ignore_case"){
+	using namespace std::string_literals;
+	using namespace std::string_view_literals;
+	const auto haystack = "ABCabcAB-XYZxyzabCD ABcd"sv;
+	for (auto&& needle : { "abcd"sv, "aBC"sv, "A"sv, "xyzXYZ"sv, "zzzz"sv, "b-xyzx"sv }) {
+		const auto searcher = peo::searcher_ignore_case{ needle };
+		for (size_t i = 0; i < haystack.size() + 2; ++i) {
+			REQUIRE(searcher.find(haystack, i) == peo::find_ignore_case(haystack, needle, i));
+		}
+		REQUIRE(searcher.contains(haystack) == peo::contains_substring_ignore_case(haystack, needle));
+		REQUIRE(
+			peo::replace_all(haystack, searcher, "-") ==
+			peo::replace_all_ignore_case(haystack, needle, "-")
+		);
+		REQUIRE(
+			peo::replace_all(std::string{ haystack }, searcher, "0123456") ==
+			peo::replace_all_ignore_case(std::string{ haystack }, needle, "0123456")
+		);
+	}
+	REQUIRE(
+		peo::searcher_ignore_case{ "aBcD"sv }.find_all("abcdABCD_abcd") ==
+		std::vector<size_t>{ 0, 4, 9 }
+	);
+	REQUIRE(peo::searcher_ignore_case{ "aA" }.count("aAaAa") == 2);
+	REQUIRE(peo::searcher_ignore_case{ L"BcD"s }.find(L"abcdef") == 1);
+}
+
+
+
+TEST_CASE("multi_searcher"){
+	const auto keywords = peo::multi_searcher{ "error", "warn", "fatal", "" };
+	REQUIRE(keywords.num_needles() == 4);
+	REQUIRE(keywords.contains_any("a fatal error"));
+	REQUIRE(!keywords.contains_any("all fine, ERROR"));
+	REQUIRE(keywords.find_first("a fatal error")->offset == 2);
+	REQUIRE(keywords.find_first("a fatal error")->needle_idx == 2);
+	REQUIRE(keywords.find_first("a fatal error", 3)->needle_idx == 0);
+	REQUIRE(!keywords.find_first("").has_value());
+	const auto keywords_ignore_case = peo::multi_searcher_ignore_case{ std::vector<std::string>{ "Error", "WARN" } };
+	REQUIRE(keywords_ignore_case.find_first("all fine, ERROR")->offset == 10);
+	REQUIRE(!peo::multi_searcher{ "" }.contains_any("abc"));
+	
+	// Compare with testing every needle at every offset, for few needles (Teddy if 
+	// available) and many needles (Aho-Corasick) with shared prefixes and suffixes
+	auto rng = std::mt19937{ 17 };
+	const auto random_string_f = [&](const size_t size) {
+		auto str = std::string{};
+		for (size_t i = 0; i < size; ++i) {
+			str += "abcAB\0\xe1"[rng() % 7];
+		}
+		return str;
+	};
+	const auto is_equal_f = [](const std::string_view a, const std::string_view b, const bool ignore_case) {
+		return ignore_case ? peo::is_equal_ignore_case(a, b, std::locale::classic()) : a == b;
+	};
+	const auto verify_f = [&](const auto& searcher, const std::vector<std::string>& needles, const bool ignore_case) {
+		for (auto iteration = 0; iteration < 20; ++iteration) {
+			const auto haystack = random_string_f(rng() % 200);
+			auto facit_matches = std::vector<std::pair<size_t, size_t>>{};
+			for (size_t offset = 0; offset < haystack.size(); ++offset) {
+				for (size_t idx = 0; idx < needles.size(); ++idx) {
+					const auto candidate = std::string_view{ haystack }.substr(offset, needles[idx].size());
+					if (!needles[idx].empty() && is_equal_f(candidate, needles[idx], ignore_case)) {
+						facit_matches.emplace_back(offset, idx);
+					}
+				}
+			}
+			const auto first = searcher.find_first(haystack);
+			REQUIRE(first.has_value() == !facit_matches.empty());
+			REQUIRE(searcher.contains_any(haystack) == !facit_matches.empty());
+			if (first.has_value()) {
+				REQUIRE(first->offset == facit_matches.front().first);
+				REQUIRE(first->needle_idx == facit_matches.front().second);
+			}
+			auto matches = std::vector<std::pair<size_t, size_t>>{};
+			searcher.for_each_match(haystack, [&matches](const auto& match) {
+				matches.emplace_back(match.offset, match.needle_idx);
+			});
+			std::sort(matches.begin(), matches.end());
+			REQUIRE(matches == facit_matches);
+		}
+	};
+	for (const auto num_needles : { 1, 2, 5, 32, 33, 100 }) {
+		for (auto repetition = 0; repetition < 5; ++repetition) {
+			auto needles = std::vector<std::string>{};
+			for (auto i = 0; i < num_needles; ++i) {
+				needles.push_back(random_string_f(rng() % 6));
+			}
+			verify_f(peo::multi_searcher{ needles }, needles, false);
+			verify_f(peo::multi_searcher_ignore_case{ needles }, needles, true);
+		}
+	}
+}
+
 TEST_CASE("contains_substring_ignore_case"){
 	REQUIRE(
 		peo::contains_substring_ignore_case("ABCCBA", "cba") ==
@@ -528,6 +1523,97 @@ TEST_CASE("join_string"){
 
 };
 
+TEST_CASE("join_strings_parallel"){
+	using namespace std::string_view_literals;
+	REQUIRE(peo::join_strings_parallel(std::vector<std::string>{}, ", ", 4).empty());
+	REQUIRE(peo::join_strings_parallel(std::array{ "a"sv, "b"sv }, ", ", 4) == "a, b");
+	auto strs = std::vector<std::string>{};
+	for (size_t i = 0; i < peo::detail::parallel_min_size + 3; ++i) {
+		strs.push_back(std::string(i % 4, 'x') + std::to_string(i));
+	}
+	REQUIRE(peo::join_strings_parallel(strs, ", ", 4) == peo::join_strings(strs, ", "));
+	REQUIRE(peo::join_strings_parallel(strs, "", 3) == peo::join_strings(strs, ""));
+	auto wide_strs = std::vector<std::wstring_view>(peo::detail::parallel_min_size * 2, L"ab"sv);
+	REQUIRE(peo::join_strings_parallel(wide_strs, L"-", 7) == peo::join_strings(wide_strs, L"-"));
+	// Not random access
+	const auto list_strs = std::list<std::string>(strs.begin(), strs.end());
+	REQUIRE(peo::join_strings_parallel(list_strs, ", ", 4) == peo::join_strings(strs, ", "));
+}
+
+TEST_CASE("join"){
+	using namespace std::string_literals;
+	enum class color_t : int8_t { red = -1, green = 7 };
+	REQUIRE(peo::join(std::vector<int>{ 1, -20, 300 }, ", ") == "1, -20, 300");
+	REQUIRE(peo::join(std::vector<int>{}, ", ").empty());
+	REQUIRE(peo::join(std::array{ true, false }, "|") == "true|false");
+	REQUIRE(peo::join(std::array{ color_t::red, color_t::green }, "") == "-17");
+	REQUIRE(peo::join(std::array{ 0.5, -1.25, 1e100 }, " ") == "0.5 -1.25 1e+100");
+	REQUIRE(peo::join(std::array{ 1.5f }, " ") == "1.5");
+	REQUIRE(peo::join(std::vector<std::string>{ "a", "bc" }, "-") == "a-bc");
+	REQUIRE(peo::join(std::array{ 'a', 'b' }, ",") == "a,b");
+	REQUIRE(peo::join(std::array{ L"x", L"yz" }, L"") == L"xyz");
+	REQUIRE(peo::join(std::vector<int64_t>{ std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max() }, L" ") == L"-9223372036854775808 9223372036854775807");
+	REQUIRE(peo::join(std::vector<uint64_t>{ std::numeric_limits<uint64_t>::max(), 0, 9, 10, 9999, 10000 }, u",") == u"18446744073709551615,0,9,10,9999,10000");
+	const auto pairs = std::vector<std::pair<std::string, double>>{ { "a", 1.0 }, { "b", 0.1 } };
+	REQUIRE(peo::join(pairs, ";", [](const auto& pair) { return pair.second; }) == "1;0.1");
+	REQUIRE(peo::join(pairs, ";", [](const auto& pair) -> const std::string& { return pair.first; }) == "a;b");
+	REQUIRE(peo::join(pairs, ";", [](const auto& pair) { return pair.first + "="s; }) == "a=;b=");
+	// Exact digit counts at the powers of ten
+	for (auto value = uint64_t{ 1 }, i = uint64_t{ 0 }; i < 19; value *= 10, ++i) {
+		REQUIRE(peo::join(std::array{ value - 1, value, value + 1 }, " ") == std::to_string(value - 1) + " " + std::to_string(value) + " " + std::to_string(value + 1));
+	}
+}
+
+TEST_CASE("string_builder"){
+	using namespace std::string_view_literals;
+	{
+		auto builder = peo::string_builder{};
+		REQUIRE(builder.empty());
+		REQUIRE(builder.finish().empty());
+		builder.append("abc"sv).append('-').append_number(42).append('-').append_number(-1.5);
+		builder.append_number(0.25, std::chars_format::fixed, 3).append_repeat('x', 3).append_repeat("ab"sv, 2);
+		REQUIRE(builder.size() == 23);
+		REQUIRE(builder.finish() == "abc-42--1.50.250xxxabab");
+		REQUIRE(builder.empty());
+	}
+	{
+		// Spans the inline buffer and several chunks
+		auto builder = peo::string_builder{};
+		auto expected = std::string{};
+		for (int i = 0; i < 2000; ++i) {
+			builder.append_number(i).append(", "sv).append_repeat('.', static_cast<size_t>(i % 7));
+			expected += std::to_string(i) + ", " + std::string(static_cast<size_t>(i % 7), '.');
+		}
+		builder.append(std::string(1000, 'y'));
+		expected += std::string(1000, 'y');
+		REQUIRE(builder.size() == expected.size());
+		auto copied = builder;
+		REQUIRE(builder.finish() == expected);
+		REQUIRE(copied.finish() == expected);
+	}
+	{
+		// A reserved chunk is handed over
+		auto builder = peo::string_builder{ 1000 };
+		builder.append(std::string(1000, 'z'));
+		const auto str = builder.finish();
+		REQUIRE(str == std::string(1000, 'z'));
+		REQUIRE(str.capacity() >= 1000);
+	}
+	{
+		auto builder = peo::basic_string_builder<char32_t>{};
+		builder.append(U"n="sv).append_number(1e300, std::chars_format::fixed).append(U'!');
+		const auto str = builder.finish();
+		REQUIRE(str.size() == 2 + 301 + 1);
+		REQUIRE(str.substr(0, 3) == U"n=1");
+		auto narrow = peo::string_builder{};
+		narrow.append_number(-1e300, std::chars_format::fixed, 2);
+		REQUIRE(narrow.finish().size() == 1 + 301 + 3);
+	}
+	REQUIRE(peo::pretty_string(std::vector<std::vector<double>>{ { 1.5 }, {}, { 2.0, -0.25 } }) == "[[1.500000] [] [2.000000 -0.250000]]");
+	REQUIRE(peo::pretty_string(std::make_tuple()) == "[]");
+	REQUIRE(peo::pretty_string(std::make_tuple(1, "a"sv, 'b')) == "[1 a 98]");
+}
+
 
 
 
@@ -681,9 +1767,64 @@ TEST_CASE("pretty_string"){
 		peo::pretty_string(dummy64_t{}) ==
 		"unknown 0x0a0b0c0d0a0b0c0d"
 	);
+	// Larger than the blocks the bytes are encoded in
+	struct dummy200_t {
+		std::array<uint8_t, 200> bytes{};
+	};
+	auto dummy200 = dummy200_t{};
+	auto dummy200_hex = std::string{ "unknown 0x" };
+	for (size_t i = 0; i < dummy200.bytes.size(); ++i) {
+		dummy200.bytes[i] = static_cast<uint8_t>(i);
+		const auto hexchars = peo::detail::uint8_to_hexchars(static_cast<uint8_t>(i));
+		dummy200_hex.append(hexchars.begin(), hexchars.end());
+	}
+	REQUIRE(peo::pretty_string(dummy200) == dummy200_hex);
 };
 
 
+template <typename Out, typename = void>
+struct is_pretty_string_to_callable : std::false_type {};
+template <typename Out>
+struct is_pretty_string_to_callable<Out, std::void_t<decltype(peo::pretty_string_to(std::declval<Out>(), 1))>> : std::true_type {};
+
+TEST_CASE("pretty_string_to"){
+	static_assert(is_pretty_string_to_callable<std::string&>::value);
+	static_assert(is_pretty_string_to_callable<char*>::value);
+	static_assert(is_pretty_string_to_callable<std::back_insert_iterator<std::string>>::value);
+	static_assert(!is_pretty_string_to_callable<const std::string&>::value);
+	static_assert(!is_pretty_string_to_callable<std::string&&>::value);
+	static_assert(!is_pretty_string_to_callable<std::string_view>::value);
+	const auto nested = std::vector<std::vector<int>>{ { 1, 2 }, {}, { -3 } };
+	auto str = std::string{ "values: " };
+	peo::pretty_string_to(str, nested);
+	REQUIRE(str == "values: [[1 2] [] [-3]]");
+	peo::pretty_string_to(str, std::make_tuple(true, 0.5, std::optional<int>{}));
+	REQUIRE(str == "values: [[1 2] [] [-3]][true 0.500000 std::nullopt]");
+
+	// Long fixed representations grow the buffer
+	str.clear();
+	peo::pretty_string_to(str, 1e300);
+	REQUIRE(str == std::to_string(1e300));
+
+	auto chars = std::vector<char>{};
+	peo::pretty_string_to(std::back_inserter(chars), nested);
+	REQUIRE(std::string_view{ chars.data(), chars.size() } == "[[1 2] [] [-3]]");
+	chars.clear();
+	peo::pretty_string_to(std::back_inserter(chars), -1e300);
+	REQUIRE(std::string{ chars.begin(), chars.end() } == std::to_string(-1e300));
+
+	auto buffer = std::array<char, 16>{};
+	const auto* end = peo::pretty_string_to(buffer.data(), std::vector<int>{ 10, 20 });
+	REQUIRE(std::string_view{ buffer.data(), static_cast<size_t>(end - buffer.data()) } == "[10 20]");
+
+	const auto large = std::vector<std::vector<int>>(1000, std::vector<int>{ 1, 22, 333 });
+	auto large_str = std::string{};
+	peo::pretty_string_to(large_str, large);
+	REQUIRE(large_str == peo::pretty_string(large));
+	REQUIRE(large_str.size() == 2 + 1000 * 10 + 999);
+}
+
+
 TEST_CASE("detail::uint8_to_hexchars") {
 	auto to_hex_via_sstr_f = [](const int value) {
 		auto sstr = std::stringstream{};
@@ -725,6 +1866,123 @@ TEST_CASE("detail::uint8_to_hexchars") {
 
 
 
+TEST_CASE("hex_encode_hex_decode") {
+	auto rng = std::mt19937{ 49 };
+	const auto random_bytes_f = [&](const size_t size) {
+		auto bytes = std::vector<uint8_t>(size);
+		for (auto& byte : bytes) {
+			byte = static_cast<uint8_t>(rng());
+		}
+		return bytes;
+	};
+	const auto reference_encode_f = [](const std::vector<uint8_t>& bytes) {
+		auto sstr = std::ostringstream{};
+		for (const auto byte : bytes) {
+			sstr << std::hex << std::setw(2) << std::setfill('0') << int{ byte };
+		}
+		return sstr.str();
+	};
+	auto sizes = std::vector<size_t>{ 1000, 4096 + 7 };
+	for (size_t size = 0; size < 100; ++size) {
+		sizes.push_back(size);
+	}
+	for (const auto size : sizes) {
+		const auto bytes = random_bytes_f(size);
+		const auto hex = peo::hex_encode(bytes);
+		REQUIRE(hex == reference_encode_f(bytes));
+		REQUIRE(peo::hex_decode(hex) == bytes);
+		REQUIRE(peo::hex_decode(peo::to_upper(hex)) == bytes);
+		if (!hex.empty()) {
+			// Every position is checked, also within the vectorized blocks
+			auto invalid = hex;
+			const auto pos = rng() % invalid.size();
+			for (const auto c : { 'g', 'G', '/', ':', '@', '`', ' ', '\xff' }) {
+				invalid[pos] = c;
+				REQUIRE(!peo::hex_decode(invalid).has_value());
+			}
+		}
+	}
+	const auto values = std::vector<uint16_t>{ 0x0102, 0xabcd };
+	auto dst = std::array<char, 8>{};
+	REQUIRE(peo::hex_encode(values, dst.data()) == dst.data() + dst.size());
+	REQUIRE(std::string_view{ dst.data(), dst.size() } == "0201cdab");
+	REQUIRE(peo::hex_encode(std::string{ "precooked" }) == "707265636f6f6b6564");
+	auto decoded = std::array<uint8_t, 2>{};
+	REQUIRE(peo::hex_decode("aBcD", decoded.data()) == decoded.data() + decoded.size());
+	REQUIRE(decoded == std::array<uint8_t, 2>{ 0xab, 0xcd });
+	REQUIRE(peo::hex_decode("abc", decoded.data()) == nullptr);
+	REQUIRE(peo::hex_decode("") == std::vector<uint8_t>{});
+}
+
+
+TEST_CASE("base64_encode_base64_decode") {
+	auto rng = std::mt19937{ 64 };
+	const auto random_bytes_f = [&](const size_t size) {
+		auto bytes = std::vector<uint8_t>(size);
+		for (auto& byte : bytes) {
+			byte = static_cast<uint8_t>(rng());
+		}
+		return bytes;
+	};
+	const auto alphabet = std::string_view{ "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/" };
+	const auto reference_encode_f = [&](const std::vector<uint8_t>& bytes) {
+		auto str = std::string{};
+		for (size_t i = 0; i < bytes.size(); i += 3) {
+			const auto num = std::min<size_t>(3, bytes.size() - i);
+			auto triple = uint32_t{ bytes[i] } << 16;
+			triple |= num > 1 ? uint32_t{ bytes[i + 1] } << 8 : 0;
+			triple |= num > 2 ? uint32_t{ bytes[i + 2] } : 0;
+			str += alphabet[(triple >> 18) & 63];
+			str += alphabet[(triple >> 12) & 63];
+			str += num > 1 ? alphabet[(triple >> 6) & 63] : '=';
+			str += num > 2 ? alphabet[triple & 63] : '=';
+		}
+		return str;
+	};
+	auto sizes = std::vector<size_t>{ 1000, 4096 + 7 };
+	for (size_t size = 0; size < 100; ++size) {
+		sizes.push_back(size);
+	}
+	for (const auto size : sizes) {
+		const auto bytes = random_bytes_f(size);
+		const auto base64 = peo::base64_encode(bytes);
+		REQUIRE(base64 == reference_encode_f(bytes));
+		REQUIRE(base64.size() == peo::base64_encoded_size(size));
+		REQUIRE(peo::base64_decoded_size(base64) == size);
+		REQUIRE(peo::base64_decode(base64) == bytes);
+		if (!base64.empty()) {
+			auto invalid = base64;
+			const auto pos = rng() % (invalid.size() - 2);
+			for (const auto c : { '=', '-', '_', '.', ' ', '@', '[', '`', '{', '\x80' }) {
+				invalid[pos] = c;
+				REQUIRE(!peo::base64_decode(invalid).has_value());
+			}
+			REQUIRE(!peo::base64_decode(base64.substr(1)).has_value());
+		}
+	}
+	// The whole alphabet passes through the vectorized blocks
+	const auto all = std::string{ alphabet } + std::string{ alphabet };
+	REQUIRE(peo::base64_encode(*peo::base64_decode(all)) == all);
+
+	REQUIRE(peo::base64_encode(std::string{ "Man" }) == "TWFu");
+	REQUIRE(peo::base64_encode(std::string{ "Ma" }) == "TWE=");
+	REQUIRE(peo::base64_encode(std::string{ "M" }) == "TQ==");
+	REQUIRE(peo::base64_encode(std::string{}) == "");
+	REQUIRE(peo::base64_decode("TWFu") == std::vector<uint8_t>{ 'M', 'a', 'n' });
+	REQUIRE(peo::base64_decode("TQ==") == std::vector<uint8_t>{ 'M' });
+	REQUIRE(!peo::base64_decode("TQ=u").has_value());
+	REQUIRE(!peo::base64_decode("T===").has_value());
+	REQUIRE(!peo::base64_decode("TQ==TWFu").has_value());
+	auto dst = std::array<char, 4>{};
+	REQUIRE(peo::base64_encode(std::string{ "Ma" }, dst.data()) == dst.data() + dst.size());
+	REQUIRE(std::string_view{ dst.data(), dst.size() } == "TWE=");
+	auto decoded = std::array<uint8_t, 2>{};
+	REQUIRE(peo::base64_decode("TWE=", decoded.data()) == decoded.data() + decoded.size());
+	REQUIRE(decoded == std::array<uint8_t, 2>{ 'M', 'a' });
+}
+
+
+
 
 
 TEST_CASE("held_type_name"){
@@ -886,3 +2144,42 @@ TEST_CASE("vector_to_string") {
 
 
 
+
+TEST_CASE("count_occurances") {
+	REQUIRE(peo::count_occurances("aaaa", "aa") == 2);
+	REQUIRE(peo::count_occurances("aaaa", "aa", true) == 3);
+	REQUIRE(peo::count_occurances("abc", "") == 0);
+	REQUIRE(peo::count_occurances(L"a\nb\nc", L"\n") == 2);
+	REQUIRE(peo::count_occurances_ignore_case("aAbA", "a") == 3);
+	// Single chars on all sizes, alignments and beyond 255 blocks
+	auto rng = std::mt19937{ 5 };
+	for (const auto size : { 0, 1, 15, 16, 33, 100, 1000, 20000 }) {
+		auto str = std::string{};
+		for (auto i = 0; i < size; ++i) {
+			str += "\n\xff-"[rng() % 3];
+		}
+		for (const auto offset : { 0, 1, 7 }) {
+			const auto sv = std::string_view{ str }.substr(std::min(str.size(), size_t(offset)));
+			REQUIRE(peo::count_occurances(sv, "\n") == static_cast<size_t>(std::count(sv.begin(), sv.end(), '\n')));
+			REQUIRE(peo::count_occurances(sv, "\xff") == static_cast<size_t>(std::count(sv.begin(), sv.end(), '\xff')));
+		}
+	}
+}
+
+TEST_CASE("count_occurances_parallel") {
+	// Large enough to be split into chunks, matches straddle the chunk boundaries
+	auto rng = std::mt19937{ 9 };
+	auto str = std::string{};
+	for (auto i = 0; i < 1 << 20; ++i) {
+		str += "ab\n"[rng() % 3];
+	}
+	for (const auto needle : { "\n", "ab", "aa", "aba", "ab\nb" }) {
+		for (const auto overlapping : { false, true }) {
+			const auto facit = peo::count_occurances(str, needle, overlapping);
+			REQUIRE(peo::count_occurances_parallel(str, needle, overlapping, 4) == facit);
+			REQUIRE(peo::count_occurances_parallel(str, needle, overlapping, 1) == facit);
+		}
+	}
+	REQUIRE(peo::count_occurances_parallel(std::string(1 << 20, 'a'), "aa", true, 4) == (1 << 20) - 1);
+	REQUIRE(peo::count_occurances_parallel(std::string(1 << 20, 'a'), "aa", false, 4) == 1 << 19);
+}